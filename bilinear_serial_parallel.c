@@ -1,8 +1,33 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* cpu_set_t / sched_setaffinity (--cpus) */
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <stdint.h>
 #include <time.h>
+#include <math.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
 #include <omp.h>
+#include <zlib.h>
+#include <signal.h>
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+#if defined(__linux__)
+#include <sched.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 /* Simple PPM image read/write (compatible fallback) */
 typedef struct {
@@ -10,300 +35,3556 @@ typedef struct {
     int width;
     int height;
     int channels; // 1 for grayscale, 3 for RGB, 4 for RGBA
+    int bit_depth; // 8 atau 16 (sample 16-bit disimpan sebagai uint16_t native-endian)
 } Image;
 
 /*
- * Baca file PNG menggunakan ImageMagick
- * KEEP COLOR - tidak dikonversi ke grayscale
+ * View citra kontigu: satu blok memori, baris ke-y ada di data + y * stride.
+ * Dipakai end-to-end (decode, resize, verifikasi, write_ppm) supaya tidak ada
+ * salinan per baris dan tidak ada pointer load tambahan per piksel.
+ * View hanya memiliki datanya jika dibuat dengan image_view_alloc().
  */
-Image* read_png_as_rgb(const char* filename) {
+typedef struct {
+    unsigned char* data;
+    int width;
+    int height;
+    int channels;
+    int bit_depth; // 8 atau 16
+    size_t stride; // jarak antar baris dalam byte (>= width * byte per piksel)
+} ImageView;
+
+#define IMAGE_ALIGN 64 // ukuran cache line
+
+static inline unsigned char* view_row(const ImageView* v, int y) {
+    return v->data + (size_t)y * v->stride;
+}
+
+static inline size_t pixel_bytes(int channels, int bit_depth) {
+    return (size_t)channels * (bit_depth / 8);
+}
+
+static inline size_t view_row_bytes(const ImageView* v) {
+    return (size_t)v->width * pixel_bytes(v->channels, v->bit_depth);
+}
+
+/*
+ * Nama format untuk log, mis. "RGB", "Grayscale 16-bit", "RGBA"
+ */
+static const char* image_format_name(int channels, int bit_depth) {
+    switch (channels) {
+        case 1:  return bit_depth == 16 ? "Grayscale 16-bit" : "Grayscale";
+        case 4:  return bit_depth == 16 ? "RGBA 16-bit" : "RGBA";
+        default: return bit_depth == 16 ? "RGB 16-bit" : "RGB";
+    }
+}
+
+/*
+ * Alokasi buffer ter-align (satu alokasi untuk seluruh citra)
+ */
+static void* aligned_buffer_alloc(size_t size) {
+    void* p = NULL;
+    if (size == 0) size = IMAGE_ALIGN;
+    if (posix_memalign(&p, IMAGE_ALIGN, size) != 0) return NULL;
+    return p;
+}
+
+/*
+ * ==================== Buffer pool (size class) ====================
+ * Buffer besar (citra, baris decode, band encode, tabel koefisien) diambil dari
+ * pool bersama. Buffer yang dikembalikan masuk free list kelasnya dan dipakai
+ * ulang oleh job berikutnya, sehingga proses yang berjalan lama (batch, server)
+ * tidak lagi malloc/page-fault buffer multi-MB di steady state.
+ * Kelas: 4 sub-kelas per pangkat dua (pemborosan maks. 25%), minimal 4 KB.
+ * Header 64 byte sebelum data menyimpan kelas; data tetap ter-align 64 byte.
+ * Semua buffer dari pool_alloc wajib dikembalikan dengan pool_free.
+ */
+#define POOL_MIN_SHIFT 12
+#define POOL_CLASSES 128
+#define POOL_HEADER IMAGE_ALIGN
+
+typedef struct PoolBlock {
+    struct PoolBlock* next;
+    int cls;
+} PoolBlock;
+
+typedef struct {
+    PoolBlock* free_list[POOL_CLASSES];
+    size_t fresh;        // alokasi baru ke sistem
+    size_t reused;       // diambil dari free list
+    size_t bytes_cached; // byte di free list
+} BufferPool;
+
+static BufferPool buffer_pool;
+
+static size_t pool_class_size(int cls) {
+    return (size_t)(4 + cls % 4) << (POOL_MIN_SHIFT - 2 + cls / 4);
+}
+
+void* pool_alloc(size_t size) {
+    size_t need = size + POOL_HEADER;
+    int cls = 0;
+    while (cls < POOL_CLASSES - 1 && pool_class_size(cls) < need) cls++;
+    if (pool_class_size(cls) < need) return NULL;
+
+    PoolBlock* blk = NULL;
+    #pragma omp critical(buffer_pool)
+    {
+        blk = buffer_pool.free_list[cls];
+        if (blk) {
+            buffer_pool.free_list[cls] = blk->next;
+            buffer_pool.bytes_cached -= pool_class_size(cls);
+            buffer_pool.reused++;
+        } else {
+            buffer_pool.fresh++;
+        }
+    }
+    if (!blk) {
+        blk = aligned_buffer_alloc(pool_class_size(cls));
+        if (!blk) return NULL;
+        blk->cls = cls;
+    }
+    return (unsigned char*)blk + POOL_HEADER;
+}
+
+void pool_free(void* p) {
+    if (!p) return;
+    PoolBlock* blk = (PoolBlock*)((unsigned char*)p - POOL_HEADER);
+    #pragma omp critical(buffer_pool)
+    {
+        blk->next = buffer_pool.free_list[blk->cls];
+        buffer_pool.free_list[blk->cls] = blk;
+        buffer_pool.bytes_cached += pool_class_size(blk->cls);
+    }
+}
+
+/*
+ * Kembalikan semua buffer yang sedang menganggur ke sistem bila cache-nya melewati
+ * max_cached byte. Ambang diperiksa di dalam critical section: pool_alloc/pool_free
+ * dari thread lain mengubah bytes_cached bersamaan.
+ */
+void pool_trim(size_t max_cached) {
+    #pragma omp critical(buffer_pool)
+    if (buffer_pool.bytes_cached > max_cached) {
+        for (int c = 0; c < POOL_CLASSES; c++) {
+            while (buffer_pool.free_list[c]) {
+                PoolBlock* blk = buffer_pool.free_list[c];
+                buffer_pool.free_list[c] = blk->next;
+                free(blk);
+            }
+        }
+        buffer_pool.bytes_cached = 0;
+    }
+}
+
+/*
+ * View tanpa salinan di atas data hasil decode (stride = lebar baris)
+ */
+ImageView image_view_of(const Image* img) {
+    ImageView v;
+    v.data = img->data;
+    v.width = img->width;
+    v.height = img->height;
+    v.channels = img->channels;
+    v.bit_depth = img->bit_depth;
+    v.stride = (size_t)img->width * pixel_bytes(img->channels, img->bit_depth);
+    return v;
+}
+
+/*
+ * Alokasi citra baru sebagai satu blok ter-align.
+ * Stride dibulatkan ke kelipatan IMAGE_ALIGN agar setiap baris mulai di cache line baru.
+ */
+int image_view_alloc(ImageView* v, int width, int height, int channels, int bit_depth) {
+    size_t row_bytes = (size_t)width * pixel_bytes(channels, bit_depth);
+    v->stride = (row_bytes + IMAGE_ALIGN - 1) & ~(size_t)(IMAGE_ALIGN - 1);
+    v->width = width;
+    v->height = height;
+    v->channels = channels;
+    v->bit_depth = bit_depth;
+    v->data = pool_alloc(v->stride * height);
+    return v->data ? 0 : -1;
+}
+
+void image_view_free(ImageView* v) {
+    pool_free(v->data);
+    v->data = NULL;
+}
+
+/*
+ * ==================== Codec PNG / PPM (in-process) ====================
+ * Decode langsung ke buffer input resize (satu alokasi ter-align), tanpa
+ * memanggil ImageMagick dan tanpa file sementara di /tmp.
+ * Format: PNG (semua color type, depth 1-16, Adam7), PPM P5/P6, PAM P7.
+ * Hasil decode tetap dalam format asli: 1 (gray), 3 (RGB) atau 4 (RGBA)
+ * channel, 8 atau 16 bit per sample. Gray+alpha di-expand ke RGBA, palette
+ * ke RGB, depth < 8 diskalakan ke 8 bit.
+ */
+static const unsigned char PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+static uint32_t read_be32(const unsigned char* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void write_be32(unsigned char* p, uint32_t v) {
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+}
+
+/*
+ * Baca seluruh file ke memori (untuk PNG: data terkompresi, relatif kecil)
+ */
+static unsigned char* read_file_bytes(const char* filename, size_t* out_len) {
+    FILE* f = fopen(filename, "rb");
+    if (!f) return NULL;
+    if (fseek(f, 0, SEEK_END) != 0) { fclose(f); return NULL; }
+    long size = ftell(f);
+    if (size < 0 || fseek(f, 0, SEEK_SET) != 0) { fclose(f); return NULL; }
+    unsigned char* buf = pool_alloc(size > 0 ? (size_t)size : 1);
+    if (buf && fread(buf, 1, (size_t)size, f) != (size_t)size) {
+        pool_free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *out_len = (size_t)size;
+    return buf;
+}
+
+static Image* image_alloc(int width, int height, int channels, int bit_depth) {
+    if (width <= 0 || height <= 0 || (size_t)width * height > ((size_t)1 << 31)) return NULL;
     Image* img = malloc(sizeof(Image));
-    char ppm_temp[] = "/tmp/temp_image.ppm";
-    char command[512];
-    
-    // Gunakan ImageMagick convert untuk baca PNG (KEEP RGB)
-    snprintf(command, sizeof(command),
-             "convert \"%s\" -depth 8 %s 2>/dev/null",
-             filename, ppm_temp);
-    
-    printf("Membaca PNG: %s (KEEP COLOR)\n", filename);
-    int ret = system(command);
-    
-    if (ret != 0) {
-        printf("❌ Error: Gagal membaca file PNG.\n");
-        printf("   Pastikan:\n");
-        printf("   1. File '%s' ada\n", filename);
-        printf("   2. ImageMagick terinstall: brew install imagemagick\n");
+    if (!img) return NULL;
+    img->width = width;
+    img->height = height;
+    img->channels = channels; // KEEP COLOR - format asli dipertahankan
+    img->bit_depth = bit_depth;
+    img->data = pool_alloc((size_t)width * height * pixel_bytes(channels, bit_depth));
+    if (!img->data) {
         free(img);
         return NULL;
     }
-    
-    // Baca PPM temporary file
-    FILE* f = fopen(ppm_temp, "rb");
-    if (!f) {
-        printf("❌ Error: Gagal membuka temporary PPM file\n");
+    return img;
+}
+
+static void image_discard(Image* img) {
+    if (img) {
+        pool_free(img->data);
         free(img);
+    }
+}
+
+/* ---------- PNG decode ---------- */
+
+typedef struct {
+    int width, height;
+    int bit_depth;
+    int color_type;   // 0 gray, 2 RGB, 3 palette, 4 gray+alpha, 6 RGBA
+    int interlace;    // 0 none, 1 Adam7
+    int samples;      // sample per piksel
+    int bpp;          // byte per piksel untuk filter (minimal 1)
+    unsigned char palette[256 * 3];
+    int palette_size;
+} PngInfo;
+
+// Sumber data IDAT untuk inflate bertahap (chunk boleh lebih dari satu)
+typedef struct {
+    z_stream zs;
+    const unsigned char* buf;
+    size_t len;
+    size_t pos;       // posisi chunk berikutnya
+    int finished;
+} PngInflater;
+
+static size_t png_row_bytes(const PngInfo* info, int width) {
+    return ((size_t)width * info->samples * info->bit_depth + 7) / 8;
+}
+
+/*
+ * Cari IDAT berikutnya dan jadikan input zlib
+ */
+static int png_next_idat(PngInflater* in) {
+    while (in->pos + 12 <= in->len) {
+        uint32_t len = read_be32(in->buf + in->pos);
+        const unsigned char* type = in->buf + in->pos + 4;
+        if ((size_t)len > in->len - in->pos - 12) return -1;
+        const unsigned char* data = in->buf + in->pos + 8;
+        in->pos += 12 + (size_t)len;
+        if (memcmp(type, "IDAT", 4) == 0) {
+            in->zs.next_in = (unsigned char*)data;
+            in->zs.avail_in = len;
+            return 0;
+        }
+        if (memcmp(type, "IEND", 4) == 0) break;
+    }
+    return -1;
+}
+
+/*
+ * Inflate tepat n byte (satu scanline) ke dst
+ */
+static int png_inflate_read(PngInflater* in, unsigned char* dst, size_t n) {
+    in->zs.next_out = dst;
+    in->zs.avail_out = (uInt)n;
+    while (in->zs.avail_out > 0) {
+        if (in->zs.avail_in == 0 && png_next_idat(in) != 0) return -1;
+        int ret = inflate(&in->zs, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END) {
+            in->finished = 1;
+            return in->zs.avail_out == 0 ? 0 : -1;
+        }
+        if (ret != Z_OK && ret != Z_BUF_ERROR) return -1;
+    }
+    return 0;
+}
+
+static inline int paeth_predictor(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = abs(p - a);
+    int pb = abs(p - b);
+    int pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    if (pb <= pc) return b;
+    return c;
+}
+
+/*
+ * Balik filter PNG satu scanline (in-place); prev berisi scanline sebelumnya (atau nol)
+ */
+static int png_unfilter(unsigned char* cur, const unsigned char* prev,
+                        size_t len, int bpp, int filter)
+{
+    size_t k;
+    switch (filter) {
+        case 0: // None
+            break;
+        case 1: // Sub
+            for (k = bpp; k < len; k++) cur[k] = (unsigned char)(cur[k] + cur[k - bpp]);
+            break;
+        case 2: // Up
+            for (k = 0; k < len; k++) cur[k] = (unsigned char)(cur[k] + prev[k]);
+            break;
+        case 3: // Average
+            for (k = 0; k < (size_t)bpp && k < len; k++) cur[k] = (unsigned char)(cur[k] + (prev[k] >> 1));
+            for (; k < len; k++) cur[k] = (unsigned char)(cur[k] + ((cur[k - bpp] + prev[k]) >> 1));
+            break;
+        case 4: // Paeth
+            for (k = 0; k < (size_t)bpp && k < len; k++) cur[k] = (unsigned char)(cur[k] + prev[k]);
+            for (; k < len; k++) {
+                cur[k] = (unsigned char)(cur[k] + paeth_predictor(cur[k - bpp], prev[k], prev[k - bpp]));
+            }
+            break;
+        default:
+            return -1;
+    }
+    return 0;
+}
+
+/*
+ * Ambil sample ke-s dari scanline (depth 1/2/4/8/16). Depth < 8 diskalakan ke
+ * 8 bit kecuali untuk indeks palette; depth 16 dikembalikan utuh.
+ */
+static inline int png_sample(const PngInfo* info, const unsigned char* raw, size_t s, int is_index) {
+    int depth = info->bit_depth;
+    if (depth == 8) return raw[s];
+    if (depth == 16) return raw[2 * s] << 8 | raw[2 * s + 1]; // big-endian
+    size_t bit = s * depth;
+    int v = (raw[bit >> 3] >> (8 - depth - (int)(bit & 7))) & ((1 << depth) - 1);
+    return is_index ? v : v * 255 / ((1 << depth) - 1);
+}
+
+// Jumlah channel hasil decode per color type PNG
+static int png_out_channels(int color_type) {
+    switch (color_type) {
+        case 0:  return 1; // gray
+        case 4:  return 4; // gray + alpha -> RGBA
+        case 6:  return 4; // RGBA
+        default: return 3; // RGB / palette
+    }
+}
+
+/*
+ * Konversi satu scanline (sudah di-unfilter) ke format asli Image.
+ * out_step = jarak byte antar piksel output (byte per piksel, atau kali dx untuk Adam7).
+ */
+static void png_row_unpack(const PngInfo* info, const unsigned char* raw, int npix,
+                           unsigned char* out, size_t out_step)
+{
+    int ch = png_out_channels(info->color_type);
+    int wide = info->bit_depth == 16;
+    if (info->bit_depth == 8 && info->color_type != 3 && info->color_type != 4 &&
+        out_step == (size_t)ch) {
+        memcpy(out, raw, (size_t)npix * ch);
+        return;
+    }
+    for (int x = 0; x < npix; x++, out += out_step) {
+        size_t s = (size_t)x * info->samples;
+        int v[4];
+        switch (info->color_type) {
+            case 0: // gray
+                v[0] = png_sample(info, raw, s, 0);
+                break;
+            case 4: // gray + alpha
+                v[0] = v[1] = v[2] = png_sample(info, raw, s, 0);
+                v[3] = png_sample(info, raw, s + 1, 0);
+                break;
+            case 3: { // palette
+                int idx = png_sample(info, raw, s, 1);
+                if (idx >= info->palette_size) idx = 0;
+                for (int c = 0; c < 3; c++) v[c] = info->palette[idx * 3 + c];
+                break;
+            }
+            default: // RGB / RGBA
+                for (int c = 0; c < ch; c++) v[c] = png_sample(info, raw, s + c, 0);
+                break;
+        }
+        if (wide) {
+            for (int c = 0; c < ch; c++) ((uint16_t*)out)[c] = (uint16_t)v[c];
+        } else {
+            for (int c = 0; c < ch; c++) out[c] = (unsigned char)v[c];
+        }
+    }
+}
+
+/*
+ * Decode PNG dari memori ke Image (format asli, lihat png_row_unpack)
+ */
+static Image* decode_png_mem(const unsigned char* buf, size_t len) {
+    PngInfo info;
+    memset(&info, 0, sizeof(info));
+    if (len < 8 + 25 || memcmp(buf, PNG_SIGNATURE, 8) != 0) return NULL;
+
+    // Header & palette (IHDR harus chunk pertama)
+    size_t pos = 8;
+    int have_ihdr = 0;
+    size_t first_chunk = pos;
+    while (pos + 12 <= len) {
+        uint32_t clen = read_be32(buf + pos);
+        const unsigned char* type = buf + pos + 4;
+        const unsigned char* data = buf + pos + 8;
+        if ((size_t)clen > len - pos - 12) return NULL;
+        if (memcmp(type, "IHDR", 4) == 0 && clen >= 13) {
+            info.width = (int)read_be32(data);
+            info.height = (int)read_be32(data + 4);
+            info.bit_depth = data[8];
+            info.color_type = data[9];
+            info.interlace = data[12];
+            have_ihdr = 1;
+        } else if (memcmp(type, "PLTE", 4) == 0) {
+            info.palette_size = (int)(clen / 3 > 256 ? 256 : clen / 3);
+            memcpy(info.palette, data, (size_t)info.palette_size * 3);
+        } else if (memcmp(type, "IDAT", 4) == 0 || memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + (size_t)clen;
+    }
+    if (!have_ihdr || info.width <= 0 || info.height <= 0 || info.interlace > 1) return NULL;
+
+    switch (info.color_type) {
+        case 0: info.samples = 1; break;
+        case 2: info.samples = 3; break;
+        case 3: info.samples = 1; break;
+        case 4: info.samples = 2; break;
+        case 6: info.samples = 4; break;
+        default: return NULL;
+    }
+    int d = info.bit_depth;
+    if (d != 1 && d != 2 && d != 4 && d != 8 && d != 16) return NULL;
+    if ((info.color_type == 2 || info.color_type == 4 || info.color_type == 6) && d < 8) return NULL;
+    if (info.color_type == 3 && (d > 8 || info.palette_size == 0)) return NULL;
+    info.bpp = (info.samples * d + 7) / 8;
+
+    Image* img = image_alloc(info.width, info.height, png_out_channels(info.color_type),
+                             d == 16 ? 16 : 8);
+    if (!img) return NULL;
+    size_t px_bytes = pixel_bytes(img->channels, img->bit_depth);
+
+    size_t max_row = png_row_bytes(&info, info.width);
+    unsigned char* prev = pool_alloc(max_row + 1);
+    unsigned char* cur = pool_alloc(max_row + 1);
+    if (prev) memset(prev, 0, max_row + 1);
+    PngInflater in;
+    memset(&in, 0, sizeof(in));
+    in.buf = buf;
+    in.len = len;
+    in.pos = first_chunk;
+    int ok = prev && cur && inflateInit(&in.zs) == Z_OK;
+
+    // Adam7: 7 pass; non-interlaced = satu pass penuh
+    static const int a7_x0[7] = { 0, 4, 0, 2, 0, 1, 0 };
+    static const int a7_y0[7] = { 0, 0, 4, 0, 2, 0, 1 };
+    static const int a7_dx[7] = { 8, 8, 4, 4, 2, 2, 1 };
+    static const int a7_dy[7] = { 8, 8, 8, 4, 4, 2, 2 };
+    int passes = info.interlace ? 7 : 1;
+
+    for (int p = 0; ok && p < passes; p++) {
+        int x0 = info.interlace ? a7_x0[p] : 0;
+        int y0 = info.interlace ? a7_y0[p] : 0;
+        int dx = info.interlace ? a7_dx[p] : 1;
+        int dy = info.interlace ? a7_dy[p] : 1;
+        int pw = (info.width - x0 + dx - 1) / dx;
+        int ph = (info.height - y0 + dy - 1) / dy;
+        if (info.width <= x0 || info.height <= y0) continue;
+
+        size_t rb = png_row_bytes(&info, pw);
+        memset(prev, 0, rb + 1);
+        for (int r = 0; ok && r < ph; r++) {
+            // cur[0] = tipe filter, cur[1..] = scanline
+            if (png_inflate_read(&in, cur, rb + 1) != 0 ||
+                png_unfilter(cur + 1, prev + 1, rb, info.bpp, cur[0]) != 0) {
+                ok = 0;
+                break;
+            }
+            int y = y0 + r * dy;
+            unsigned char* out = img->data + ((size_t)y * info.width + x0) * px_bytes;
+            png_row_unpack(&info, cur + 1, pw, out, (size_t)dx * px_bytes);
+            unsigned char* t = prev; prev = cur; cur = t;
+        }
+    }
+
+    inflateEnd(&in.zs);
+    pool_free(prev);
+    pool_free(cur);
+    if (!ok) {
+        image_discard(img);
         return NULL;
     }
-    
-    char magic[3];
-    fscanf(f, "%2s", magic);
-    
-    if (magic[0] != 'P' || magic[1] != '6') {
-        printf("❌ Error: Invalid PPM format\n");
+    return img;
+}
+
+/* ---------- PPM (P5/P6) / PAM (P7) decode ---------- */
+
+typedef struct {
+    int width, height;
+    int depth;         // sample per piksel
+    int maxval;
+    size_t header_len; // offset data piksel
+} PnmHeader;
+
+static int pnm_skip_space(const unsigned char* buf, size_t len, size_t* pos) {
+    while (*pos < len) {
+        unsigned char c = buf[*pos];
+        if (c == '#') {
+            while (*pos < len && buf[*pos] != '\n') (*pos)++;
+        } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            (*pos)++;
+        } else {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int pnm_read_int(const unsigned char* buf, size_t len, size_t* pos, int* out) {
+    if (pnm_skip_space(buf, len, pos) != 0) return -1;
+    long v = 0;
+    int digits = 0;
+    while (*pos < len && buf[*pos] >= '0' && buf[*pos] <= '9') {
+        v = v * 10 + (buf[*pos] - '0');
+        if (v > 0x7FFFFFFF) return -1;
+        (*pos)++;
+        digits++;
+    }
+    *out = (int)v;
+    return digits > 0 ? 0 : -1;
+}
+
+/*
+ * Parse header P5/P6/P7 dari awal buffer
+ */
+static int parse_pnm_header(const unsigned char* buf, size_t len, PnmHeader* h) {
+    if (len < 3 || buf[0] != 'P') return -1;
+    size_t pos = 2;
+    memset(h, 0, sizeof(*h));
+
+    if (buf[1] == '5' || buf[1] == '6') {
+        h->depth = buf[1] == '6' ? 3 : 1;
+        if (pnm_read_int(buf, len, &pos, &h->width) != 0 ||
+            pnm_read_int(buf, len, &pos, &h->height) != 0 ||
+            pnm_read_int(buf, len, &pos, &h->maxval) != 0) {
+            return -1;
+        }
+        if (pos >= len) return -1;
+        pos++; // satu whitespace setelah maxval
+    } else if (buf[1] == '7') {
+        // PAM: baris "KEY value" sampai ENDHDR
+        for (;;) {
+            if (pnm_skip_space(buf, len, &pos) != 0) return -1;
+            const char* key = (const char*)buf + pos;
+            size_t rest = len - pos;
+            if (rest >= 6 && strncmp(key, "ENDHDR", 6) == 0) {
+                pos += 6;
+                while (pos < len && buf[pos] != '\n') pos++;
+                if (pos >= len) return -1;
+                pos++;
+                break;
+            }
+            int* target = NULL;
+            size_t klen = 0;
+            if (rest >= 5 && strncmp(key, "WIDTH", 5) == 0)       { target = &h->width;  klen = 5; }
+            else if (rest >= 6 && strncmp(key, "HEIGHT", 6) == 0) { target = &h->height; klen = 6; }
+            else if (rest >= 5 && strncmp(key, "DEPTH", 5) == 0)  { target = &h->depth;  klen = 5; }
+            else if (rest >= 6 && strncmp(key, "MAXVAL", 6) == 0) { target = &h->maxval; klen = 6; }
+            if (target) {
+                pos += klen;
+                if (pnm_read_int(buf, len, &pos, target) != 0) return -1;
+            } else {
+                while (pos < len && buf[pos] != '\n') pos++; // TUPLTYPE, dll
+            }
+        }
+    } else {
+        return -1;
+    }
+
+    if (h->width <= 0 || h->height <= 0 || h->depth < 1 || h->depth > 4 ||
+        h->maxval < 1 || h->maxval > 65535) {
+        return -1;
+    }
+    h->header_len = pos;
+    return 0;
+}
+
+static size_t pnm_data_bytes(const PnmHeader* h) {
+    return (size_t)h->width * h->height * h->depth * (h->maxval > 255 ? 2 : 1);
+}
+
+// Channel hasil decode PNM: gray+alpha (depth 2) di-expand ke RGBA
+static int pnm_out_channels(const PnmHeader* h) {
+    return h->depth == 2 ? 4 : h->depth;
+}
+
+// Data file bisa langsung dipakai (tanpa konversi) jika 8-bit penuh dan bukan gray+alpha
+static int pnm_is_native(const PnmHeader* h) {
+    return h->maxval == 255 && h->depth != 2;
+}
+
+static Image* pnm_alloc_image(const PnmHeader* h) {
+    return image_alloc(h->width, h->height, pnm_out_channels(h), h->maxval > 255 ? 16 : 8);
+}
+
+/*
+ * Konversi sample PNM ke format Image: gray+alpha di-expand ke RGBA,
+ * 16-bit big-endian -> native, maxval lain diskalakan ke 255 / 65535.
+ */
+static void pnm_to_native(const PnmHeader* h, const unsigned char* raw, Image* img) {
+    size_t npix = (size_t)h->width * h->height;
+    int wide = h->maxval > 255;
+    int full = wide ? 65535 : 255;
+    int ch = img->channels;
+    uint16_t* out16 = (uint16_t*)img->data;
+    for (size_t p = 0; p < npix; p++) {
+        for (int c = 0; c < ch; c++) {
+            int s = h->depth == 2 ? (c == 3 ? 1 : 0) : c;
+            size_t k = p * h->depth + s;
+            int v = wide ? (raw[2 * k] << 8 | raw[2 * k + 1]) : raw[k];
+            if (h->maxval != full) {
+                v = (int)(((int64_t)v * full + h->maxval / 2) / h->maxval);
+            }
+            if (wide) {
+                out16[p * ch + c] = (uint16_t)v;
+            } else {
+                img->data[p * ch + c] = (unsigned char)v;
+            }
+        }
+    }
+}
+
+static Image* decode_pnm_mem(const unsigned char* buf, size_t len) {
+    PnmHeader h;
+    if (parse_pnm_header(buf, len, &h) != 0) return NULL;
+    if (len - h.header_len < pnm_data_bytes(&h)) return NULL;
+    Image* img = pnm_alloc_image(&h);
+    if (!img) return NULL;
+    if (pnm_is_native(&h)) {
+        memcpy(img->data, buf + h.header_len, pnm_data_bytes(&h));
+    } else {
+        pnm_to_native(&h, buf + h.header_len, img);
+    }
+    return img;
+}
+
+/*
+ * Decode dari memori (PNG atau PPM/PAM, dideteksi dari magic bytes)
+ */
+Image* decode_image_mem(const unsigned char* buf, size_t len) {
+    if (len >= 8 && memcmp(buf, PNG_SIGNATURE, 8) == 0) return decode_png_mem(buf, len);
+    if (len >= 2 && buf[0] == 'P') return decode_pnm_mem(buf, len);
+    return NULL;
+}
+
+/*
+ * PPM/PAM dari file: header di-parse dari prefix, lalu piksel dibaca
+ * langsung (fread) ke buffer input resize tanpa salinan perantara.
+ */
+static Image* read_pnm_file(FILE* f) {
+    unsigned char head[4096];
+    size_t got = fread(head, 1, sizeof(head), f);
+    PnmHeader h;
+    if (parse_pnm_header(head, got, &h) != 0) return NULL;
+    if (fseek(f, (long)h.header_len, SEEK_SET) != 0) return NULL;
+
+    Image* img = pnm_alloc_image(&h);
+    if (!img) return NULL;
+    size_t bytes = pnm_data_bytes(&h);
+    if (pnm_is_native(&h)) {
+        if (fread(img->data, 1, bytes, f) != bytes) {
+            image_discard(img);
+            return NULL;
+        }
+    } else {
+        unsigned char* raw = pool_alloc(bytes);
+        if (!raw || fread(raw, 1, bytes, f) != bytes) {
+            pool_free(raw);
+            image_discard(img);
+            return NULL;
+        }
+        pnm_to_native(&h, raw, img);
+        pool_free(raw);
+    }
+    return img;
+}
+
+/*
+ * Decode file tanpa pesan (aman untuk task / mode JSON).
+ * *kind = "PNG" / "PPM" / "PAM", atau NULL jika file tidak bisa dibuka.
+ */
+static Image* load_image_file(const char* filename, const char** kind) {
+    *kind = NULL;
+    FILE* f = fopen(filename, "rb");
+    if (!f) return NULL;
+    unsigned char magic[8] = { 0 };
+    size_t n = fread(magic, 1, sizeof(magic), f);
+    rewind(f);
+
+    Image* img = NULL;
+    *kind = "PNG";
+    if (n >= 2 && magic[0] == 'P' && magic[1] >= '5' && magic[1] <= '7') {
+        *kind = magic[1] == '7' ? "PAM" : "PPM";
+        img = read_pnm_file(f);
+        fclose(f);
+    } else {
         fclose(f);
+        size_t len = 0;
+        unsigned char* buf = read_file_bytes(filename, &len);
+        if (buf) img = decode_png_mem(buf, len);
+        pool_free(buf);
+    }
+    return img;
+}
+
+/*
+ * Baca file gambar (PNG / PPM / PAM) dalam format aslinya
+ * KEEP COLOR - tidak dikonversi ke grayscale / RGB
+ */
+Image* read_image(const char* filename) {
+    printf("Membaca gambar: %s (KEEP COLOR)\n", filename);
+
+    const char* kind = NULL;
+    Image* img = load_image_file(filename, &kind);
+    if (!kind) {
+        printf("❌ Error: File '%s' tidak dapat dibuka\n", filename);
+        return NULL;
+    }
+    if (!img) {
+        printf("❌ Error: Gagal decode %s (format tidak valid / tidak didukung)\n", filename);
+        return NULL;
+    }
+    printf("✅ Berhasil membaca %s: %dx%d (%s)\n", kind, img->width, img->height,
+           img->channels == 3 && img->bit_depth == 8 ? "RGB Color"
+                                                      : image_format_name(img->channels, img->bit_depth));
+    return img;
+}
+
+/*
+ * ==================== Writer PPM (tanpa stdio per byte) ====================
+ * Header + buffer piksel kontigu ditulis dengan writev (satu syscall jika
+ * stride == lebar baris), atau disalin ke file yang di-mmap.
+ */
+#ifndef IOV_MAX
+#define IOV_MAX 1024 // batas POSIX minimum yang umum (Linux/macOS)
+#endif
+
+typedef enum {
+    PPM_WRITE_WRITEV = 0,
+    PPM_WRITE_MMAP
+} PpmWriteMode;
+
+/*
+ * Header sesuai format: P5 (gray), P6 (RGB) atau PAM P7 (RGBA); maxval 65535 untuk 16-bit
+ */
+static int ppm_header(char* buf, size_t cap, const ImageView* img) {
+    int maxval = img->bit_depth == 16 ? 65535 : 255;
+    if (img->channels == 4) {
+        return snprintf(buf, cap, "P7\nWIDTH %d\nHEIGHT %d\nDEPTH 4\nMAXVAL %d\n"
+                        "TUPLTYPE RGB_ALPHA\nENDHDR\n", img->width, img->height, maxval);
+    }
+    return snprintf(buf, cap, "P%c\n%d %d\n%d\n", img->channels == 1 ? '5' : '6',
+                    img->width, img->height, maxval);
+}
+
+/*
+ * Salin n sample 16-bit native ke big-endian (urutan byte file PNM/PNG)
+ */
+static void store_be16(unsigned char* dst, const unsigned char* src, size_t n) {
+    const uint16_t* s16 = (const uint16_t*)src;
+    for (size_t k = 0; k < n; k++) {
+        dst[2 * k] = (unsigned char)(s16[k] >> 8);
+        dst[2 * k + 1] = (unsigned char)s16[k];
+    }
+}
+
+/*
+ * writev sampai semua iovec tertulis (menangani partial write & batas IOV_MAX)
+ */
+static int writev_all(int fd, struct iovec* iov, int cnt) {
+    while (cnt > 0) {
+        int batch = cnt < IOV_MAX ? cnt : IOV_MAX;
+        ssize_t n = writev(fd, iov, batch);
+        if (n < 0) return -1;
+        while (cnt > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            cnt--;
+        }
+        if (cnt > 0 && n > 0) {
+            iov->iov_base = (char*)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Tulis baris [y0, y1) ke fd. Jika baris kontigu (stride == lebar baris),
+ * cukup satu iovec untuk seluruh rentang.
+ */
+static int write_rows_fd(int fd, const ImageView* img, int y0, int y1,
+                         const void* header, size_t header_len)
+{
+    size_t row_bytes = view_row_bytes(img);
+    if (img->bit_depth == 16) {
+        // Sample 16-bit harus big-endian di file: konversi ke buffer sementara
+        unsigned char* be = pool_alloc(row_bytes * (y1 - y0) + 1);
+        if (!be) return -1;
+        for (int y = y0; y < y1; y++) {
+            store_be16(be + row_bytes * (y - y0), view_row(img, y), row_bytes / 2);
+        }
+        struct iovec iov[2];
+        int k = 0;
+        if (header_len) {
+            iov[k].iov_base = (void*)header;
+            iov[k++].iov_len = header_len;
+        }
+        iov[k].iov_base = be;
+        iov[k++].iov_len = row_bytes * (y1 - y0);
+        int ret = writev_all(fd, iov, k);
+        pool_free(be);
+        return ret;
+    }
+    int contiguous = img->stride == row_bytes;
+    int rows = y1 - y0;
+    int cnt = (header_len ? 1 : 0) + (contiguous ? 1 : rows);
+    struct iovec stack_iov[64];
+    struct iovec* iov = cnt <= 64 ? stack_iov : malloc((size_t)cnt * sizeof(struct iovec));
+    if (!iov) return -1;
+
+    int k = 0;
+    if (header_len) {
+        iov[k].iov_base = (void*)header;
+        iov[k++].iov_len = header_len;
+    }
+    if (contiguous) {
+        iov[k].iov_base = view_row(img, y0);
+        iov[k++].iov_len = row_bytes * rows;
+    } else {
+        for (int y = y0; y < y1; y++) {
+            iov[k].iov_base = view_row(img, y);
+            iov[k++].iov_len = row_bytes;
+        }
+    }
+    int ret = writev_all(fd, iov, cnt);
+    if (iov != stack_iov) free(iov);
+    return ret;
+}
+
+/*
+ * Header + piksel dalam satu writev (tanpa pesan, aman dipanggil dari task)
+ */
+int write_ppm_file(const char* filename, const ImageView* img) {
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+    char header[128];
+    int hlen = ppm_header(header, sizeof(header), img);
+    int ret = write_rows_fd(fd, img, 0, img->height, header, (size_t)hlen);
+    if (close(fd) != 0) ret = -1;
+    return ret;
+}
+
+/*
+ * Tulis hasil ke file PPM / PGM / PAM (sesuai jumlah channel)
+ */
+int write_ppm(const char* filename, const ImageView* img) {
+    int ret = write_ppm_file(filename, img);
+    if (ret == 0) {
+        printf("✅ Hasil disimpan ke: %s\n", filename);
+    } else {
+        printf("❌ Error: Gagal menulis file %s\n", filename);
+    }
+    return ret;
+}
+
+/*
+ * Tulis PPM lewat mmap: file di-ftruncate ke ukuran akhir lalu baris disalin
+ * langsung ke page cache (tanpa buffer user-space tambahan).
+ */
+int write_ppm_mmap(const char* filename, const ImageView* img) {
+    char header[128];
+    int hlen = ppm_header(header, sizeof(header), img);
+    size_t row_bytes = view_row_bytes(img);
+    size_t total = (size_t)hlen + row_bytes * img->height;
+
+    int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        printf("❌ Error: Gagal membuat file %s\n", filename);
+        return -1;
+    }
+    if (ftruncate(fd, (off_t)total) != 0) {
+        close(fd);
+        return -1;
+    }
+    unsigned char* map = mmap(NULL, total, PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+    memcpy(map, header, (size_t)hlen);
+    unsigned char* dst = map + hlen;
+    if (img->bit_depth == 16) {
+        for (int y = 0; y < img->height; y++) {
+            store_be16(dst + row_bytes * y, view_row(img, y), row_bytes / 2);
+        }
+    } else if (img->stride == row_bytes) {
+        memcpy(dst, img->data, row_bytes * img->height);
+    } else {
+        for (int y = 0; y < img->height; y++) {
+            memcpy(dst + row_bytes * y, view_row(img, y), row_bytes);
+        }
+    }
+    int ret = munmap(map, total);
+    if (close(fd) != 0) ret = -1;
+    if (ret == 0) printf("✅ Hasil disimpan ke: %s (mmap)\n", filename);
+    return ret;
+}
+
+int write_ppm_with(const char* filename, const ImageView* img, PpmWriteMode mode) {
+    return mode == PPM_WRITE_MMAP ? write_ppm_mmap(filename, img) : write_ppm(filename, img);
+}
+
+/* ---------- PNG encode (paralel per band baris) ---------- */
+
+#define PNG_DEFAULT_LEVEL 1          // deflate cepat
+#define PNG_BAND_MIN_BYTES (256 * 1024) // minimal data mentah per band (rasio kompresi)
+
+/*
+ * Pilih & terapkan filter untuk satu baris. Level <= 3: selalu Sub (murah);
+ * level lebih tinggi: heuristik minimum-sum-of-absolute-differences (seperti libpng).
+ */
+static void png_filter_row(const unsigned char* row, const unsigned char* prev,
+                           size_t len, int bpp, int level, unsigned char* out)
+{
+    if (level <= 3) {
+        out[0] = 1;
+        for (size_t k = 0; k < len; k++) {
+            out[1 + k] = (unsigned char)(row[k] - (k >= (size_t)bpp ? row[k - bpp] : 0));
+        }
+        return;
+    }
+
+    int best = 0;
+    unsigned long best_sum = (unsigned long)-1;
+    for (int f = 0; f <= 4; f++) {
+        unsigned long sum = 0;
+        for (size_t k = 0; k < len && sum < best_sum; k++) {
+            int a = k >= (size_t)bpp ? row[k - bpp] : 0;
+            int b = prev ? prev[k] : 0;
+            int c = (prev && k >= (size_t)bpp) ? prev[k - bpp] : 0;
+            int pred = f == 0 ? 0 : f == 1 ? a : f == 2 ? b : f == 3 ? (a + b) >> 1 : paeth_predictor(a, b, c);
+            sum += (unsigned long)abs((signed char)(row[k] - pred));
+        }
+        if (sum < best_sum) {
+            best_sum = sum;
+            best = f;
+        }
+    }
+    out[0] = (unsigned char)best;
+    for (size_t k = 0; k < len; k++) {
+        int a = k >= (size_t)bpp ? row[k - bpp] : 0;
+        int b = prev ? prev[k] : 0;
+        int c = (prev && k >= (size_t)bpp) ? prev[k - bpp] : 0;
+        int pred = best == 0 ? 0 : best == 1 ? a : best == 2 ? b : best == 3 ? (a + b) >> 1 : paeth_predictor(a, b, c);
+        out[1 + k] = (unsigned char)(row[k] - pred);
+    }
+}
+
+// Hasil kompresi satu band: data chunk IDAT lengkap (length, type, data, crc)
+typedef struct {
+    unsigned char* chunk;
+    size_t chunk_len;
+    uLong adler;
+    size_t raw_len;
+    int ok;
+} PngBand;
+
+static void png_put_chunk(unsigned char* dst, const char* type, const unsigned char* data, size_t len) {
+    write_be32(dst, (uint32_t)len);
+    memcpy(dst + 4, type, 4);
+    if (len && data != dst + 8) memcpy(dst + 8, data, len);
+    uLong crc = crc32(0L, dst + 4, (uInt)(len + 4));
+    write_be32(dst + 8 + len, (uint32_t)crc);
+}
+
+/*
+ * Filter + deflate satu band baris menjadi satu chunk IDAT.
+ * Band bukan-terakhir diakhiri Z_SYNC_FLUSH (byte aligned, BFINAL=0) sehingga
+ * stream deflate antar band bisa disambung (teknik pigz). Band pertama membawa
+ * header zlib; trailer adler32 ditulis sebagai chunk terpisah di akhir.
+ */
+static void png_encode_band(const ImageView* img, int level, int y_begin, int y_end,
+                            int first, int last, PngBand* band)
+{
+    size_t row_bytes = view_row_bytes(img);
+    int bpp = (int)pixel_bytes(img->channels, img->bit_depth);
+    size_t raw_len = (size_t)(y_end - y_begin) * (row_bytes + 1);
+    unsigned char* raw = pool_alloc(raw_len);
+    // 16-bit: filter bekerja pada byte big-endian, jadi baris dikonversi dulu (cur + prev)
+    unsigned char* be = img->bit_depth == 16 ? pool_alloc(2 * row_bytes) : NULL;
+    band->ok = 0;
+    band->chunk = NULL;
+    if (!raw || (img->bit_depth == 16 && !be)) {
+        pool_free(raw);
+        pool_free(be);
+        return;
+    }
+
+    for (int y = y_begin; y < y_end; y++) {
+        const unsigned char* row = view_row(img, y);
+        const unsigned char* prev = y > 0 ? view_row(img, y - 1) : NULL;
+        if (be) {
+            unsigned char* be_cur = be + (size_t)(y & 1) * row_bytes;
+            unsigned char* be_prev = be + (size_t)((y + 1) & 1) * row_bytes;
+            if (prev && y == y_begin) store_be16(be_prev, prev, row_bytes / 2);
+            store_be16(be_cur, row, row_bytes / 2);
+            row = be_cur;
+            prev = prev ? be_prev : NULL;
+        }
+        png_filter_row(row, prev, row_bytes, bpp, level,
+                       raw + (size_t)(y - y_begin) * (row_bytes + 1));
+    }
+    pool_free(be);
+    band->adler = adler32(adler32(0L, Z_NULL, 0), raw, (uInt)raw_len);
+    band->raw_len = raw_len;
+
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        pool_free(raw);
+        return;
+    }
+    size_t bound = deflateBound(&zs, (uLong)raw_len) + 16;
+    band->chunk = pool_alloc(bound + 12 + 2);
+    if (!band->chunk) {
+        deflateEnd(&zs);
+        pool_free(raw);
+        return;
+    }
+
+    unsigned char* data = band->chunk + 8;
+    size_t prefix = 0;
+    if (first) {
+        // Header zlib: CMF=0x78 (deflate, window 32K), FLG sesuai level (FCHECK valid)
+        data[0] = 0x78;
+        data[1] = level <= 1 ? 0x01 : level <= 5 ? 0x5E : level == 6 ? 0x9C : 0xDA;
+        prefix = 2;
+    }
+    zs.next_in = raw;
+    zs.avail_in = (uInt)raw_len;
+    zs.next_out = data + prefix;
+    zs.avail_out = (uInt)(bound - prefix);
+    int ret = deflate(&zs, last ? Z_FINISH : Z_SYNC_FLUSH);
+    size_t data_len = prefix + (bound - prefix - zs.avail_out);
+    deflateEnd(&zs);
+    pool_free(raw);
+
+    if ((last && ret != Z_STREAM_END) || (!last && ret != Z_OK)) {
+        pool_free(band->chunk);
+        band->chunk = NULL;
+        return;
+    }
+    png_put_chunk(band->chunk, "IDAT", data, data_len);
+    band->chunk_len = data_len + 12;
+    band->ok = 1;
+}
+
+/*
+ * Encode view RGB/gray/RGBA 8- atau 16-bit ke PNG di memori.
+ * level: 0..9 (zlib); band di-kompres paralel dengan OpenMP.
+ * *out berasal dari pool_alloc dan dilepas pemanggil dengan pool_free.
+ */
+int encode_png_mem(const ImageView* img, int level, unsigned char** out, size_t* out_len) {
+    int color_type;
+    switch (img->channels) {
+        case 1: color_type = 0; break;
+        case 3: color_type = 2; break;
+        case 4: color_type = 6; break;
+        default: return -1;
+    }
+    if (level < 0) level = 0;
+    if (level > 9) level = 9;
+
+    size_t row_bytes = view_row_bytes(img);
+    int band_h = (int)(PNG_BAND_MIN_BYTES / (row_bytes + 1)) + 1;
+    int max_bands = omp_get_max_threads() * 2;
+    if ((img->height + band_h - 1) / band_h > max_bands * 4) {
+        band_h = (img->height + max_bands * 4 - 1) / (max_bands * 4);
+    }
+    int n_bands = (img->height + band_h - 1) / band_h;
+    PngBand* bands = calloc(n_bands, sizeof(PngBand));
+    if (!bands) return -1;
+
+    if (omp_in_parallel()) {
+        // Dipanggil dari task (mis. pipeline batch): pakai thread tim yang sudah ada
+        #pragma omp taskloop
+        for (int b = 0; b < n_bands; b++) {
+            int y_end = (b + 1) * band_h < img->height ? (b + 1) * band_h : img->height;
+            png_encode_band(img, level, b * band_h, y_end, b == 0, b == n_bands - 1, &bands[b]);
+        }
+    } else {
+        #pragma omp parallel for schedule(dynamic)
+        for (int b = 0; b < n_bands; b++) {
+            int y_end = (b + 1) * band_h < img->height ? (b + 1) * band_h : img->height;
+            png_encode_band(img, level, b * band_h, y_end, b == 0, b == n_bands - 1, &bands[b]);
+        }
+    }
+
+    // Gabungkan: signature + IHDR + IDAT per band + IDAT(adler32) + IEND
+    int ok = 1;
+    size_t total = 8 + 25 + 16 + 12;
+    uLong adler = adler32(0L, Z_NULL, 0);
+    for (int b = 0; b < n_bands; b++) {
+        if (!bands[b].ok) ok = 0;
+        total += bands[b].chunk_len;
+        adler = adler32_combine(adler, bands[b].adler, (z_off_t)bands[b].raw_len);
+    }
+
+    unsigned char* png = ok ? pool_alloc(total) : NULL;
+    if (png) {
+        unsigned char* p = png;
+        memcpy(p, PNG_SIGNATURE, 8);
+        p += 8;
+        unsigned char ihdr[13];
+        write_be32(ihdr, (uint32_t)img->width);
+        write_be32(ihdr + 4, (uint32_t)img->height);
+        ihdr[8] = (unsigned char)img->bit_depth;
+        ihdr[9] = (unsigned char)color_type;
+        ihdr[10] = ihdr[11] = ihdr[12] = 0;
+        png_put_chunk(p, "IHDR", ihdr, 13);
+        p += 25;
+        for (int b = 0; b < n_bands; b++) {
+            memcpy(p, bands[b].chunk, bands[b].chunk_len);
+            p += bands[b].chunk_len;
+        }
+        unsigned char trailer[4];
+        write_be32(trailer, (uint32_t)adler);
+        png_put_chunk(p, "IDAT", trailer, 4);
+        p += 16;
+        png_put_chunk(p, "IEND", NULL, 0);
+        p += 12;
+        *out = png;
+        *out_len = (size_t)(p - png);
+    }
+
+    for (int b = 0; b < n_bands; b++) pool_free(bands[b].chunk);
+    free(bands);
+    return png ? 0 : -1;
+}
+
+/*
+ * Tulis view ke file PNG (level deflate dipilih per panggilan)
+ */
+int write_png(const char* filename, const ImageView* img, int level) {
+    unsigned char* png = NULL;
+    size_t len = 0;
+    if (encode_png_mem(img, level, &png, &len) != 0) return -1;
+    FILE* f = fopen(filename, "wb");
+    int ok = f && fwrite(png, 1, len, f) == len;
+    if (f && fclose(f) != 0) ok = 0;
+    pool_free(png);
+    return ok ? 0 : -1;
+}
+
+/*
+ * Fungsi interpolasi bilinear untuk satu titik
+ */
+static inline double bilinear_interpolate(
+    double x, double y,
+    double Q11, double Q21, double Q12, double Q22)
+{
+    double fx1 = Q11 + (Q21 - Q11) * x;
+    double fx2 = Q12 + (Q22 - Q12) * x;
+    return fx1 + (fx2 - fx1) * y;
+}
+
+/*
+ * Mode kernel resize:
+ *  - KERNEL_DOUBLE : referensi, koordinat & bobot dihitung ulang per piksel (double)
+ *  - KERNEL_FIXED  : fixed-point 8.8 dengan tabel koefisien yang dihitung sekali
+ *  - KERNEL_SIMD   : fixed-point yang sama, divektorisasi (ISA dipilih saat runtime)
+ */
+typedef enum {
+    KERNEL_DOUBLE = 0,
+    KERNEL_FIXED,
+    KERNEL_SIMD
+} KernelMode;
+
+static const char* kernel_mode_name(KernelMode mode) {
+    switch (mode) {
+        case KERNEL_FIXED: return "fixed";
+        case KERNEL_SIMD:  return "simd";
+        default:           return "double";
+    }
+}
+
+/*
+ * Fixed-point 8.8: bobot dx/dy disimpan sebagai bilangan bulat 0..256 (Q8).
+ * Aturan pembulatan (round-half-up di dua tempat):
+ *   w   = floor(d * 256 + 0.5)                       (kuantisasi bobot)
+ *   top = p00 * (256 - wx) + p01 * wx                (<= 255 * 256, exact)
+ *   bot = p10 * (256 - wx) + p11 * wx
+ *   out = (top * (256 - wy) + bot * wy + 2^15) >> 16 (<= 255, tanpa clamp)
+ * Error kuantisasi bobot <= 1/512 per sumbu, sehingga hasil berbeda maksimal
+ * 1 LSB dari kernel double (lihat FIXED_TOLERANCE).
+ */
+#define FIXED_BITS 8
+#define FIXED_ONE (1 << FIXED_BITS)
+#define FIXED_ROUND (1 << (2 * FIXED_BITS - 1))
+#define FIXED_TOLERANCE 1
+
+/*
+ * Citra 16-bit memakai bobot Q16 dengan aturan yang sama (akumulator 64-bit),
+ * sehingga error kuantisasi tetap <= 1 LSB dalam skala 16-bit.
+ */
+#define FIXED16_BITS 16
+
+/*
+ * Tabel koefisien resize: dibangun sekali per (ukuran sumber, ukuran hasil).
+ * Tabel x sudah di-expand per channel (indeks e = j * channels + c) sehingga
+ * inner loop menjadi loop 1-D tanpa perkalian indeks.
+ */
+typedef struct {
+    int src_w, src_h;
+    int new_w, new_h;
+    int channels;
+    double x_ratio, y_ratio; // dipakai kernel double (referensi)
+
+    int* y0;  // baris sumber atas per baris output
+    int* y1;  // baris sumber bawah
+    int* wy;  // bobot baris bawah (Q8)
+
+    int n_elems; // new_w * channels
+    int* xl;  // offset byte piksel kiri per elemen output
+    int* xr;  // offset byte piksel kanan per elemen output
+    int* wx;  // bobot piksel kanan (Q8) per elemen output
+    int n_safe; // elemen [0, n_safe) aman untuk gather 32-bit (xr + 3 masih di dalam baris)
+    int bit_depth;   // 8 atau 16 (menentukan presisi bobot)
+    int weight_bits; // FIXED_BITS (8-bit) atau FIXED16_BITS (16-bit)
+} ResizeCoeffs;
+
+static inline int quantize_weight(double d, int bits) {
+    int one = 1 << bits;
+    int w = (int)(d * one + 0.5);
+    if (w < 0) w = 0;
+    if (w > one) w = one;
+    return w;
+}
+
+void resize_coeffs_free(ResizeCoeffs* co) {
+    pool_free(co->y0); pool_free(co->y1); pool_free(co->wy);
+    pool_free(co->xl); pool_free(co->xr); pool_free(co->wx);
+    memset(co, 0, sizeof(*co));
+}
+
+/*
+ * Bangun tabel indeks & bobot (rumus sama dengan kernel double)
+ */
+int resize_coeffs_build(ResizeCoeffs* co, int src_w, int src_h,
+                        int new_w, int new_h, int channels, int bit_depth)
+{
+    memset(co, 0, sizeof(*co));
+    co->bit_depth = bit_depth;
+    co->weight_bits = bit_depth == 16 ? FIXED16_BITS : FIXED_BITS;
+    co->src_w = src_w;
+    co->src_h = src_h;
+    co->new_w = new_w;
+    co->new_h = new_h;
+    co->channels = channels;
+    co->x_ratio = new_w > 1 ? (double)(src_w - 1) / (double)(new_w - 1) : 0.0;
+    co->y_ratio = new_h > 1 ? (double)(src_h - 1) / (double)(new_h - 1) : 0.0;
+    co->n_elems = new_w * channels;
+
+    co->y0 = pool_alloc(new_h * sizeof(int));
+    co->y1 = pool_alloc(new_h * sizeof(int));
+    co->wy = pool_alloc(new_h * sizeof(int));
+    co->xl = pool_alloc(co->n_elems * sizeof(int));
+    co->xr = pool_alloc(co->n_elems * sizeof(int));
+    co->wx = pool_alloc(co->n_elems * sizeof(int));
+    if (!co->y0 || !co->y1 || !co->wy || !co->xl || !co->xr || !co->wx) {
+        resize_coeffs_free(co);
+        return -1;
+    }
+
+    // Tabel y: sekali per tinggi
+    for (int i = 0; i < new_h; i++) {
+        double src_y = i * co->y_ratio;
+        int y1 = (int)src_y;
+        if (y1 >= src_h - 1) y1 = src_h - 2;
+        if (y1 < 0) y1 = 0;
+        co->y0[i] = y1;
+        co->y1[i] = y1 + 1 < src_h ? y1 + 1 : y1;
+        co->wy[i] = quantize_weight(src_y - y1, co->weight_bits);
+    }
+
+    // Tabel x: sekali per lebar, di-expand per channel
+    for (int j = 0; j < new_w; j++) {
+        double src_x = j * co->x_ratio;
+        int x1 = (int)src_x;
+        if (x1 >= src_w - 1) x1 = src_w - 2;
+        if (x1 < 0) x1 = 0;
+        int x2 = x1 + 1 < src_w ? x1 + 1 : x1;
+        int w = quantize_weight(src_x - x1, co->weight_bits);
+        for (int c = 0; c < channels; c++) {
+            int e = j * channels + c;
+            co->xl[e] = x1 * channels + c;
+            co->xr[e] = x2 * channels + c;
+            co->wx[e] = w;
+        }
+    }
+
+    // Gather SIMD membaca 4 byte mulai dari offset; sisa elemen di ujung diproses scalar
+    int row_bytes = src_w * channels;
+    co->n_safe = 0;
+    while (co->n_safe < co->n_elems && co->xr[co->n_safe] + 4 <= row_bytes) {
+        co->n_safe++;
+    }
+    return 0;
+}
+
+/*
+ * Kernel satu baris output i dari dua baris sumber r0 (= baris co->y0[i]) dan
+ * r1 (= baris co->y1[i]). Driver (serial, paralel, streaming) hanya berbeda
+ * pada pembagian baris dan asal pointer baris sumber.
+ */
+typedef void (*resize_row_fn)(const unsigned char* r0, const unsigned char* r1,
+                              unsigned char* out, const ResizeCoeffs* co, int i);
+
+/*
+ * Kernel dispesialisasi saat compile per (tipe sample, jumlah channel): C adalah
+ * konstanta sehingga loop channel di-unroll penuh dan offset x1 * C menjadi
+ * shift/lea. Row pointer tetap unsigned char* (stride dalam byte) dan di-cast
+ * ke tipe sample di dalam kernel. Varian dipilih sekali per citra
+ * (select_row_kernel).
+ */
+
+/*
+ * Kernel DOUBLE (referensi) - hitung ulang koordinat per piksel
+ */
+#define DEFINE_RESIZE_ROW_DOUBLE(NAME, T, C, MAXV)                                   \
+static void NAME(const unsigned char* r0_, const unsigned char* r1_,                 \
+                 unsigned char* out_, const ResizeCoeffs* co, int i)                 \
+{                                                                                    \
+    const T* row1 = (const T*)r0_; /* baris y1 dan y1 + 1 (co->y0[i] / co->y1[i]) */ \
+    const T* row2 = (const T*)r1_;                                                   \
+    T* out = (T*)out_;                                                               \
+    int src_h = co->src_h;                                                           \
+    int src_w = co->src_w;                                                           \
+                                                                                     \
+    for (int j = 0; j < co->new_w; j++) {                                            \
+        double src_x = j * co->x_ratio;                                              \
+        double src_y = i * co->y_ratio;                                              \
+                                                                                     \
+        int x1 = (int)src_x;                                                         \
+        int y1 = (int)src_y;                                                         \
+                                                                                     \
+        /* Boundary check */                                                         \
+        if (x1 >= src_w - 1) x1 = src_w - 2;                                         \
+        if (y1 >= src_h - 1) y1 = src_h - 2;                                         \
+        if (x1 < 0) x1 = 0;                                                          \
+        if (y1 < 0) y1 = 0;                                                          \
+                                                                                     \
+        int x2 = x1 + 1 < src_w ? x1 + 1 : x1;                                       \
+                                                                                     \
+        double dx = src_x - x1;                                                      \
+        double dy = src_y - y1;                                                      \
+                                                                                     \
+        for (int c = 0; c < C; c++) {                                                \
+            double Q11 = row1[x1 * C + c];                                           \
+            double Q21 = row1[x2 * C + c];                                           \
+            double Q12 = row2[x1 * C + c];                                           \
+            double Q22 = row2[x2 * C + c];                                           \
+                                                                                     \
+            double val = bilinear_interpolate(dx, dy, Q11, Q21, Q12, Q22);           \
+                                                                                     \
+            if (val < 0) val = 0;                                                    \
+            if (val > MAXV) val = MAXV;                                              \
+                                                                                     \
+            out[j * C + c] = (T)(val + 0.5);                                         \
+        }                                                                            \
+    }                                                                                \
+}
+
+/*
+ * Kernel FIXED-POINT - hanya lookup tabel + integer multiply-add.
+ * Tabel dibaca sekali per piksel (elemen channel 0), channel lain = offset +c.
+ */
+#define DEFINE_RESIZE_ROW_FIXED(NAME, T, C, ACC, BITS)                               \
+static void NAME(const unsigned char* r0_, const unsigned char* r1_,                 \
+                 unsigned char* out_, const ResizeCoeffs* co, int i)                 \
+{                                                                                    \
+    const T* r0 = (const T*)r0_;                                                     \
+    const T* r1 = (const T*)r1_;                                                     \
+    T* out = (T*)out_;                                                               \
+    const ACC one = (ACC)1 << (BITS);                                                \
+    const ACC round = (ACC)1 << (2 * (BITS) - 1);                                    \
+    const ACC wy = (ACC)co->wy[i];                                                   \
+    const ACC iwy = one - wy;                                                        \
+    const int* xl = co->xl;                                                          \
+    const int* xr = co->xr;                                                          \
+    const int* wx = co->wx;                                                          \
+                                                                                     \
+    for (int j = 0; j < co->new_w; j++) {                                            \
+        int e = j * C;                                                               \
+        const T* a0 = r0 + xl[e];                                                    \
+        const T* b0 = r0 + xr[e];                                                    \
+        const T* a1 = r1 + xl[e];                                                    \
+        const T* b1 = r1 + xr[e];                                                    \
+        ACC w = (ACC)wx[e];                                                          \
+        ACC iw = one - w;                                                            \
+        for (int c = 0; c < C; c++) {                                                \
+            ACC top = a0[c] * iw + b0[c] * w;                                        \
+            ACC bot = a1[c] * iw + b1[c] * w;                                        \
+            out[e + c] = (T)((top * iwy + bot * wy + round) >> (2 * (BITS)));        \
+        }                                                                            \
+    }                                                                                \
+}
+
+DEFINE_RESIZE_ROW_DOUBLE(resize_row_double_u8c1, unsigned char, 1, 255)
+DEFINE_RESIZE_ROW_DOUBLE(resize_row_double_u8c3, unsigned char, 3, 255)
+DEFINE_RESIZE_ROW_DOUBLE(resize_row_double_u8c4, unsigned char, 4, 255)
+DEFINE_RESIZE_ROW_DOUBLE(resize_row_double_u16c1, uint16_t, 1, 65535)
+DEFINE_RESIZE_ROW_DOUBLE(resize_row_double_u16c3, uint16_t, 3, 65535)
+DEFINE_RESIZE_ROW_DOUBLE(resize_row_double_u16c4, uint16_t, 4, 65535)
+
+DEFINE_RESIZE_ROW_FIXED(resize_row_fixed_u8c1, unsigned char, 1, uint32_t, FIXED_BITS)
+DEFINE_RESIZE_ROW_FIXED(resize_row_fixed_u8c3, unsigned char, 3, uint32_t, FIXED_BITS)
+DEFINE_RESIZE_ROW_FIXED(resize_row_fixed_u8c4, unsigned char, 4, uint32_t, FIXED_BITS)
+DEFINE_RESIZE_ROW_FIXED(resize_row_fixed_u16c1, uint16_t, 1, uint64_t, FIXED16_BITS)
+DEFINE_RESIZE_ROW_FIXED(resize_row_fixed_u16c3, uint16_t, 3, uint64_t, FIXED16_BITS)
+DEFINE_RESIZE_ROW_FIXED(resize_row_fixed_u16c4, uint16_t, 4, uint64_t, FIXED16_BITS)
+
+/*
+ * ==================== SIMD (fixed-point, runtime dispatch) ====================
+ * Kernel SIMD bekerja di ruang elemen (e = j * channels + c) memakai tabel
+ * xl/xr/wx yang sudah di-expand per channel, jadi RGB interleaved tidak perlu
+ * di-deinterleave: setiap lane memuat satu channel dari satu piksel output
+ * (mis. 8 lane AVX2 = R,G,B,R,G,B,R,G). Aritmetika identik dengan
+ * resize_row_fixed_u8cN (lane 32-bit), sehingga hasil bit-identik dengan scalar.
+ */
+typedef enum {
+    ISA_SCALAR = 0,
+    ISA_SSE41,
+    ISA_AVX2,
+    ISA_AVX512,
+    ISA_COUNT
+} IsaLevel;
+
+static const char* isa_name(IsaLevel isa) {
+    switch (isa) {
+        case ISA_SSE41:  return "sse4.1";
+        case ISA_AVX2:   return "avx2";
+        case ISA_AVX512: return "avx512";
+        default:         return "scalar";
+    }
+}
+
+// ISA yang dipakai oleh KERNEL_SIMD (diset sekali di main dari detect_isa)
+static IsaLevel simd_isa = ISA_SCALAR;
+
+/*
+ * Deteksi ISA terbaik saat runtime (cpuid via __builtin_cpu_supports),
+ * sehingga satu binary bisa jalan di semua node.
+ */
+static IsaLevel detect_isa(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return ISA_AVX512;
+    if (__builtin_cpu_supports("avx2"))    return ISA_AVX2;
+    if (__builtin_cpu_supports("sse4.1"))  return ISA_SSE41;
+#endif
+    return ISA_SCALAR;
+}
+
+static inline unsigned char fixed_elem(const unsigned char* r0, const unsigned char* r1,
+                                       int l, int r, int w, int wy)
+{
+    int iw = FIXED_ONE - w;
+    int top = r0[l] * iw + r0[r] * w;
+    int bot = r1[l] * iw + r1[r] * w;
+    return (unsigned char)((top * (FIXED_ONE - wy) + bot * wy + FIXED_ROUND) >> (2 * FIXED_BITS));
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("sse4.1")))
+static void resize_row_sse41(const unsigned char* r0, const unsigned char* r1,
+                             unsigned char* out, const ResizeCoeffs* co, int i)
+{
+    const int wy = co->wy[i];
+    const int* xl = co->xl;
+    const int* xr = co->xr;
+    const __m128i vone = _mm_set1_epi32(FIXED_ONE);
+    const __m128i vwy = _mm_set1_epi32(wy);
+    const __m128i viwy = _mm_set1_epi32(FIXED_ONE - wy);
+    const __m128i vround = _mm_set1_epi32(FIXED_ROUND);
+
+    int e = 0;
+    for (; e + 8 <= co->n_elems; e += 8) {
+        __m128i acc[2];
+        for (int h = 0; h < 2; h++) {
+            int k = e + 4 * h;
+            // SSE4.1 tidak punya gather: rakit lane dari load byte
+            __m128i a = _mm_setr_epi32(r0[xl[k]], r0[xl[k + 1]], r0[xl[k + 2]], r0[xl[k + 3]]);
+            __m128i b = _mm_setr_epi32(r0[xr[k]], r0[xr[k + 1]], r0[xr[k + 2]], r0[xr[k + 3]]);
+            __m128i c = _mm_setr_epi32(r1[xl[k]], r1[xl[k + 1]], r1[xl[k + 2]], r1[xl[k + 3]]);
+            __m128i d = _mm_setr_epi32(r1[xr[k]], r1[xr[k + 1]], r1[xr[k + 2]], r1[xr[k + 3]]);
+            __m128i w = _mm_loadu_si128((const __m128i*)(co->wx + k));
+            __m128i iw = _mm_sub_epi32(vone, w);
+            __m128i top = _mm_add_epi32(_mm_mullo_epi32(a, iw), _mm_mullo_epi32(b, w));
+            __m128i bot = _mm_add_epi32(_mm_mullo_epi32(c, iw), _mm_mullo_epi32(d, w));
+            __m128i v = _mm_add_epi32(_mm_mullo_epi32(top, viwy), _mm_mullo_epi32(bot, vwy));
+            acc[h] = _mm_srli_epi32(_mm_add_epi32(v, vround), 2 * FIXED_BITS);
+        }
+        __m128i p16 = _mm_packus_epi32(acc[0], acc[1]);
+        _mm_storel_epi64((__m128i*)(out + e), _mm_packus_epi16(p16, p16));
+    }
+    for (; e < co->n_elems; e++) {
+        out[e] = fixed_elem(r0, r1, xl[e], xr[e], co->wx[e], wy);
+    }
+}
+
+__attribute__((target("avx2")))
+static void resize_row_avx2(const unsigned char* r0, const unsigned char* r1,
+                            unsigned char* out, const ResizeCoeffs* co, int i)
+{
+    const int wy = co->wy[i];
+    const int* xl = co->xl;
+    const int* xr = co->xr;
+    const __m256i vone = _mm256_set1_epi32(FIXED_ONE);
+    const __m256i vwy = _mm256_set1_epi32(wy);
+    const __m256i viwy = _mm256_set1_epi32(FIXED_ONE - wy);
+    const __m256i vround = _mm256_set1_epi32(FIXED_ROUND);
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+
+    // Gather 32-bit per byte offset; hanya sampai n_safe agar tidak membaca lewat ujung baris
+    int e = 0;
+    for (; e + 8 <= co->n_safe; e += 8) {
+        __m256i il = _mm256_loadu_si256((const __m256i*)(xl + e));
+        __m256i ir = _mm256_loadu_si256((const __m256i*)(xr + e));
+        __m256i a = _mm256_and_si256(_mm256_i32gather_epi32((const int*)r0, il, 1), mask);
+        __m256i b = _mm256_and_si256(_mm256_i32gather_epi32((const int*)r0, ir, 1), mask);
+        __m256i c = _mm256_and_si256(_mm256_i32gather_epi32((const int*)r1, il, 1), mask);
+        __m256i d = _mm256_and_si256(_mm256_i32gather_epi32((const int*)r1, ir, 1), mask);
+        __m256i w = _mm256_loadu_si256((const __m256i*)(co->wx + e));
+        __m256i iw = _mm256_sub_epi32(vone, w);
+        __m256i top = _mm256_add_epi32(_mm256_mullo_epi32(a, iw), _mm256_mullo_epi32(b, w));
+        __m256i bot = _mm256_add_epi32(_mm256_mullo_epi32(c, iw), _mm256_mullo_epi32(d, w));
+        __m256i v = _mm256_add_epi32(_mm256_mullo_epi32(top, viwy), _mm256_mullo_epi32(bot, vwy));
+        v = _mm256_srli_epi32(_mm256_add_epi32(v, vround), 2 * FIXED_BITS);
+        __m128i p16 = _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        _mm_storel_epi64((__m128i*)(out + e), _mm_packus_epi16(p16, p16));
+    }
+    for (; e < co->n_elems; e++) {
+        out[e] = fixed_elem(r0, r1, xl[e], xr[e], co->wx[e], wy);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void resize_row_avx512(const unsigned char* r0, const unsigned char* r1,
+                              unsigned char* out, const ResizeCoeffs* co, int i)
+{
+    const int wy = co->wy[i];
+    const int* xl = co->xl;
+    const int* xr = co->xr;
+    const __m512i vone = _mm512_set1_epi32(FIXED_ONE);
+    const __m512i vwy = _mm512_set1_epi32(wy);
+    const __m512i viwy = _mm512_set1_epi32(FIXED_ONE - wy);
+    const __m512i vround = _mm512_set1_epi32(FIXED_ROUND);
+    const __m512i mask = _mm512_set1_epi32(0xFF);
+
+    int e = 0;
+    for (; e + 16 <= co->n_safe; e += 16) {
+        __m512i il = _mm512_loadu_si512((const void*)(xl + e));
+        __m512i ir = _mm512_loadu_si512((const void*)(xr + e));
+        __m512i a = _mm512_and_si512(_mm512_i32gather_epi32(il, (const void*)r0, 1), mask);
+        __m512i b = _mm512_and_si512(_mm512_i32gather_epi32(ir, (const void*)r0, 1), mask);
+        __m512i c = _mm512_and_si512(_mm512_i32gather_epi32(il, (const void*)r1, 1), mask);
+        __m512i d = _mm512_and_si512(_mm512_i32gather_epi32(ir, (const void*)r1, 1), mask);
+        __m512i w = _mm512_loadu_si512((const void*)(co->wx + e));
+        __m512i iw = _mm512_sub_epi32(vone, w);
+        __m512i top = _mm512_add_epi32(_mm512_mullo_epi32(a, iw), _mm512_mullo_epi32(b, w));
+        __m512i bot = _mm512_add_epi32(_mm512_mullo_epi32(c, iw), _mm512_mullo_epi32(d, w));
+        __m512i v = _mm512_add_epi32(_mm512_mullo_epi32(top, viwy), _mm512_mullo_epi32(bot, vwy));
+        v = _mm512_srli_epi32(_mm512_add_epi32(v, vround), 2 * FIXED_BITS);
+        _mm_storeu_si128((__m128i*)(out + e), _mm512_cvtepi32_epi8(v)); // nilai <= 255
+    }
+    for (; e < co->n_elems; e++) {
+        out[e] = fixed_elem(r0, r1, xl[e], xr[e], co->wx[e], wy);
+    }
+}
+
+#endif /* x86 */
+
+/*
+ * Kernel SIMD untuk citra 8-bit (channel berapa pun, karena bekerja di ruang
+ * elemen); NULL = pakai kernel fixed-point scalar.
+ */
+static resize_row_fn select_simd_kernel(IsaLevel isa) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch (isa) {
+        case ISA_AVX512: return resize_row_avx512;
+        case ISA_AVX2:   return resize_row_avx2;
+        case ISA_SSE41:  return resize_row_sse41;
+        default:         break;
+    }
+#else
+    (void)isa;
+#endif
+    return NULL;
+}
+
+/*
+ * Pilih kernel sekali per citra dari (mode, channel, bit depth).
+ * 16-bit pada KERNEL_SIMD memakai kernel fixed-point Q16 scalar.
+ */
+static resize_row_fn select_row_kernel(KernelMode mode, int channels, int bit_depth) {
+    static const resize_row_fn double_kernels[2][3] = {
+        { resize_row_double_u8c1, resize_row_double_u8c3, resize_row_double_u8c4 },
+        { resize_row_double_u16c1, resize_row_double_u16c3, resize_row_double_u16c4 },
+    };
+    static const resize_row_fn fixed_kernels[2][3] = {
+        { resize_row_fixed_u8c1, resize_row_fixed_u8c3, resize_row_fixed_u8c4 },
+        { resize_row_fixed_u16c1, resize_row_fixed_u16c3, resize_row_fixed_u16c4 },
+    };
+    int d = bit_depth == 16 ? 1 : 0;
+    int c = channels == 1 ? 0 : channels == 4 ? 2 : 1;
+
+    if (mode == KERNEL_SIMD && !d) {
+        resize_row_fn simd = select_simd_kernel(simd_isa);
+        if (simd) return simd;
+    }
+    return mode == KERNEL_DOUBLE ? double_kernels[d][c] : fixed_kernels[d][c];
+}
+
+/*
+ * Cek view tujuan milik pemanggil: ada buffer, dimensi valid, format sama dengan sumber
+ */
+static int resize_dst_compatible(const ImageView* src, const ImageView* dst) {
+    return dst->data && dst->width > 0 && dst->height > 0 &&
+           dst->channels == src->channels && dst->bit_depth == src->bit_depth &&
+           dst->stride >= view_row_bytes(dst);
+}
+
+/*
+ * VERSI SERIAL ke buffer milik pemanggil - ukuran hasil diambil dari dst.
+ * Tidak ada alokasi citra; pemanggil bisa memakai dst yang sama berulang kali.
+ * Return 0 jika sukses, -1 jika dst tidak cocok / tabel gagal dibangun.
+ */
+int bilinear_resize_serial_into(const ImageView* src, ImageView* dst, KernelMode mode)
+{
+    ResizeCoeffs co;
+    if (!resize_dst_compatible(src, dst)) return -1;
+    if (resize_coeffs_build(&co, src->width, src->height, dst->width, dst->height,
+                            src->channels, src->bit_depth) != 0) {
+        return -1;
+    }
+    resize_row_fn row_kernel = select_row_kernel(mode, src->channels, src->bit_depth);
+
+    // Loop SERIAL - tidak ada paralelisasi
+    for (int i = 0; i < dst->height; i++) {
+        row_kernel(view_row(src, co.y0[i]), view_row(src, co.y1[i]), view_row(dst, i), &co, i);
+    }
+
+    resize_coeffs_free(&co);
+    return 0;
+}
+
+/*
+ * VERSI SERIAL - Resize citra (gray/RGB/RGBA, 8/16-bit) menggunakan interpolasi bilinear
+ * Membaca langsung dari view sumber (tanpa salinan), hasil berupa satu blok ter-align.
+ */
+ImageView bilinear_resize_serial(const ImageView* src, int new_h, int new_w, KernelMode mode)
+{
+    ImageView dst;
+    if (image_view_alloc(&dst, new_w, new_h, src->channels, src->bit_depth) != 0) return dst; // data == NULL
+    if (bilinear_resize_serial_into(src, &dst, mode) != 0) image_view_free(&dst);
+    return dst;
+}
+
+/*
+ * ==================== Tile scheduler ====================
+ * Output dibagi menjadi band baris. Tinggi band dipilih agar footprint sumber
+ * (baris yang dibaca band tsb) + output band muat di setengah L2, sehingga
+ * baris sumber yang dipakai ulang oleh baris output berikutnya tetap di cache.
+ */
+static size_t l2_cache_bytes(void) {
+    static size_t cached = 0;
+    if (cached) return cached;
+    long v = -1;
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+    v = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+#if defined(__APPLE__)
+    if (v <= 0) {
+        uint64_t l2 = 0;
+        size_t len = sizeof(l2);
+        if (sysctlbyname("hw.l2cachesize", &l2, &len, NULL, 0) == 0) v = (long)l2;
+    }
+#endif
+    cached = v > 0 ? (size_t)v : (size_t)1 << 20; // fallback 1 MB
+    return cached;
+}
+
+/*
+ * Tinggi band (baris output) untuk ukuran sumber/hasil tertentu.
+ * Dibatasi juga agar setiap thread mendapat minimal beberapa band (load balance).
+ */
+int plan_band_height(int src_w, int src_h, int new_w, int new_h,
+                     int bytes_per_pixel, int num_threads)
+{
+    size_t budget = l2_cache_bytes() / 2;
+    double y_ratio = new_h > 1 ? (double)(src_h - 1) / (double)(new_h - 1) : 0.0;
+    size_t src_row = (size_t)src_w * bytes_per_pixel;
+    size_t dst_row = (size_t)new_w * bytes_per_pixel;
+
+    int band_h = 1;
+    while (band_h < new_h) {
+        int next = band_h * 2;
+        size_t src_rows = (size_t)(next * y_ratio) + 2;
+        if (src_rows * src_row + (size_t)next * dst_row > budget) break;
+        band_h = next;
+    }
+
+    // Minimal 4 band per thread supaya ketidakseimbangan di ujung kecil
+    int min_bands = num_threads * 4;
+    int max_h = (new_h + min_bands - 1) / min_bands;
+    if (band_h > max_h) band_h = max_h;
+    if (band_h < 1) band_h = 1;
+    return band_h;
+}
+
+/*
+ * VERSI PARALEL ke buffer milik pemanggil - ukuran hasil diambil dari dst.
+ * Setiap thread mendapat band-band yang kontigu (schedule static). Buffer hasil
+ * tidak di-memset, sehingga halaman output baru pertama kali disentuh (first-touch)
+ * oleh thread pemilik band dan ditempatkan di node NUMA thread tersebut.
+ * Return 0 jika sukses, -1 jika dst tidak cocok / tabel gagal dibangun.
+ */
+int bilinear_resize_parallel_into(const ImageView* src, ImageView* dst,
+                                  int num_threads, KernelMode mode)
+{
+    ResizeCoeffs co;
+    int new_w = dst->width, new_h = dst->height;
+    if (!resize_dst_compatible(src, dst)) return -1;
+    if (resize_coeffs_build(&co, src->width, src->height, new_w, new_h,
+                            src->channels, src->bit_depth) != 0) {
+        return -1;
+    }
+    resize_row_fn row_kernel = select_row_kernel(mode, src->channels, src->bit_depth);
+
+    int band_h = plan_band_height(src->width, src->height, new_w, new_h,
+                                   (int)pixel_bytes(src->channels, src->bit_depth), num_threads);
+    int n_bands = (new_h + band_h - 1) / band_h;
+
+    // Loop PARALEL per band (bukan per piksel) menggunakan OpenMP
+    #pragma omp parallel for schedule(static) num_threads(num_threads)
+    for (int b = 0; b < n_bands; b++) {
+        int i_end = (b + 1) * band_h < new_h ? (b + 1) * band_h : new_h;
+        for (int i = b * band_h; i < i_end; i++) {
+            row_kernel(view_row(src, co.y0[i]), view_row(src, co.y1[i]),
+                       view_row(dst, i), &co, i);
+        }
+    }
+
+    resize_coeffs_free(&co);
+    return 0;
+}
+
+/*
+ * VERSI PARALEL - Resize citra (gray/RGB/RGBA, 8/16-bit) menggunakan OpenMP
+ */
+ImageView bilinear_resize_parallel(const ImageView* src, int new_h, int new_w,
+                                   int num_threads, KernelMode mode)
+{
+    ImageView dst;
+    if (image_view_alloc(&dst, new_w, new_h, src->channels, src->bit_depth) != 0) return dst; // data == NULL
+    if (bilinear_resize_parallel_into(src, &dst, num_threads, mode) != 0) image_view_free(&dst);
+    return dst;
+}
+
+/*
+ * VERSI PARALEL + TULIS OVERLAP - band N ditulis ke file PPM (task) sementara
+ * band N+1 dihitung (taskloop) oleh thread lain. Hasil tetap dikembalikan
+ * utuh untuk verifikasi / encode PNG.
+ */
+ImageView bilinear_resize_parallel_to_ppm(const ImageView* src, int new_h, int new_w,
+                                          int num_threads, KernelMode mode,
+                                          const char* filename)
+{
+    ImageView dst;
+    ResizeCoeffs co;
+    if (image_view_alloc(&dst, new_w, new_h, src->channels, src->bit_depth) != 0) return dst; // data == NULL
+    if (resize_coeffs_build(&co, src->width, src->height, new_w, new_h,
+                            src->channels, src->bit_depth) != 0) {
+        image_view_free(&dst);
+        return dst;
+    }
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        printf("❌ Error: Gagal membuat file %s\n", filename);
+        resize_coeffs_free(&co);
+        image_view_free(&dst);
+        return dst;
+    }
+    resize_row_fn row_kernel = select_row_kernel(mode, src->channels, src->bit_depth);
+    int band_h = plan_band_height(src->width, src->height, new_w, new_h,
+                                   (int)pixel_bytes(src->channels, src->bit_depth), num_threads);
+    int n_bands = (new_h + band_h - 1) / band_h;
+    char header[128];
+    int hlen = ppm_header(header, sizeof(header), &dst);
+    int write_ok = 1;
+
+    #pragma omp parallel num_threads(num_threads)
+    #pragma omp single
+    {
+        for (int b = 0; b < n_bands; b++) {
+            int i0 = b * band_h;
+            int i1 = i0 + band_h < new_h ? i0 + band_h : new_h;
+
+            #pragma omp taskloop num_tasks(num_threads)
+            for (int i = i0; i < i1; i++) {
+                row_kernel(view_row(src, co.y0[i]), view_row(src, co.y1[i]),
+                           view_row(&dst, i), &co, i);
+            }
+
+            // Satu task tulis aktif sekaligus -> urutan band di file terjaga
+            #pragma omp taskwait
+            #pragma omp task firstprivate(i0, i1, b)
+            {
+                if (write_rows_fd(fd, &dst, i0, i1, header, b == 0 ? (size_t)hlen : 0) != 0) {
+                    write_ok = 0;
+                }
+            }
+        }
+        #pragma omp taskwait
+    }
+
+    if (close(fd) != 0) write_ok = 0;
+    resize_coeffs_free(&co);
+    if (!write_ok) {
+        printf("❌ Error: Gagal menulis %s\n", filename);
+        image_view_free(&dst);
+    }
+    return dst;
+}
+
+/*
+ * Ukuran hasil untuk faktor scaling tertentu (minimal 1x1)
+ */
+void resize_target_dims(int src_w, int src_h, double scale, int* new_w, int* new_h) {
+    *new_h = (int)(src_h * scale + 0.5);
+    *new_w = (int)(src_w * scale + 0.5);
+    if (*new_h < 1) *new_h = 1;
+    if (*new_w < 1) *new_w = 1;
+}
+
+/*
+ * ==================== Streaming (out-of-core) resize ====================
+ * Sumber PPM/PAM dibaca per rentang baris dengan pread. Hanya baris sumber
+ * yang dibutuhkan band output saat ini yang disimpan (strip), dan setiap band
+ * output langsung ditulis begitu selesai. Memori puncak ~ O(lebar), bukan
+ * O(lebar x tinggi), sehingga citra lebih besar dari RAM tetap bisa di-resize.
+ */
+typedef struct {
+    int src_w, src_h;
+    int new_w, new_h;
+    int channels, bit_depth;
+    int band_h;
+    size_t peak_bytes;   // strip + band output + tabel koefisien
+    size_t bytes_read;
+    size_t bytes_written;
+} StreamStats;
+
+static int pread_full(int fd, unsigned char* buf, size_t n, off_t offset) {
+    while (n > 0) {
+        ssize_t got = pread(fd, buf, n, offset);
+        if (got <= 0) return -1;
+        buf += got;
+        n -= (size_t)got;
+        offset += got;
+    }
+    return 0;
+}
+
+int stream_resize_pnm(const char* in_path, const char* out_path, double scale,
+                      KernelMode mode, int num_threads, int overlap, StreamStats* stats)
+{
+    int fd = open(in_path, O_RDONLY);
+    if (fd < 0) {
+        printf("❌ Error: File '%s' tidak dapat dibuka\n", in_path);
+        return -1;
+    }
+    unsigned char head[4096];
+    ssize_t got = pread(fd, head, sizeof(head), 0);
+    PnmHeader h;
+    if (got <= 0 || parse_pnm_header(head, (size_t)got, &h) != 0) {
+        printf("❌ Error: Streaming hanya mendukung input PGM/PPM (P5/P6) / PAM (P7)\n");
+        close(fd);
+        return -1;
+    }
+    if (h.depth == 2 || (h.maxval != 255 && h.maxval != 65535)) {
+        printf("❌ Error: Streaming butuh 1/3/4 channel dengan maxval 255 atau 65535\n");
+        close(fd);
+        return -1;
+    }
+    int ch = h.depth;
+    int bit_depth = h.maxval == 65535 ? 16 : 8;
+    size_t px = pixel_bytes(ch, bit_depth);
+
+    memset(stats, 0, sizeof(*stats));
+    stats->src_w = h.width;
+    stats->src_h = h.height;
+    stats->channels = ch;
+    stats->bit_depth = bit_depth;
+    resize_target_dims(h.width, h.height, scale, &stats->new_w, &stats->new_h);
+    int new_w = stats->new_w;
+    int new_h = stats->new_h;
+
+    ResizeCoeffs co;
+    if (resize_coeffs_build(&co, h.width, h.height, new_w, new_h, ch, bit_depth) != 0) {
+        close(fd);
+        return -1;
+    }
+    resize_row_fn row_kernel = select_row_kernel(mode, ch, bit_depth);
+    int band_h = plan_band_height(h.width, h.height, new_w, new_h, (int)px, num_threads);
+    int n_bands = (new_h + band_h - 1) / band_h;
+    stats->band_h = band_h;
+
+    // Kapasitas strip = jumlah baris sumber terbanyak yang dibutuhkan satu band
+    int max_rows = 2;
+    for (int b = 0; b < n_bands; b++) {
+        int i0 = b * band_h;
+        int i1 = i0 + band_h < new_h ? i0 + band_h : new_h;
+        int rows = co.y1[i1 - 1] - co.y0[i0] + 1;
+        if (rows > max_rows) max_rows = rows;
+    }
+    size_t src_row = (size_t)h.width * px;
+    ImageView strip = { NULL, h.width, max_rows, ch, bit_depth, src_row };
+    strip.data = pool_alloc(src_row * max_rows);
+
+    // Dua buffer band jika overlap (band N ditulis sementara band N+1 dihitung)
+    int n_buf = overlap ? 2 : 1;
+    ImageView band[2] = { { 0 }, { 0 } };
+    int band_ok = 1;
+    for (int k = 0; k < n_buf; k++) {
+        if (image_view_alloc(&band[k], new_w, band_h, ch, bit_depth) != 0) band_ok = 0;
+    }
+    int out = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (!strip.data || !band_ok || out < 0) {
+        printf("❌ Error: Gagal menyiapkan buffer / file output streaming\n");
+        pool_free(strip.data);
+        for (int k = 0; k < n_buf; k++) image_view_free(&band[k]);
+        if (out >= 0) close(out);
+        resize_coeffs_free(&co);
+        close(fd);
+        return -1;
+    }
+    stats->peak_bytes = src_row * max_rows + band[0].stride * band_h * n_buf +
+                        (size_t)new_h * 3 * sizeof(int) + (size_t)co.n_elems * 3 * sizeof(int);
+
+    char header[128];
+    ImageView out_desc = { NULL, new_w, new_h, ch, bit_depth, 0 };
+    int hlen = ppm_header(header, sizeof(header), &out_desc);
+    stats->bytes_written = (size_t)hlen + (size_t)new_w * px * new_h;
+
+    int read_ok = 1, write_ok = 1;
+    int lo = 0, hi = -1; // baris sumber yang sedang ada di strip: [lo, hi]
+
+    #pragma omp parallel num_threads(num_threads)
+    #pragma omp single
+    {
+        // Status task tulis (--overlap): ditulis task, dibaca hanya setelah taskwait lalu
+        // digabung ke write_ok; kondisi loop tidak membaca memori yang ditulis task
+        int write_failed = 0;
+        for (int b = 0; b < n_bands && read_ok && write_ok; b++) {
+            int i0 = b * band_h;
+            int i1 = i0 + band_h < new_h ? i0 + band_h : new_h;
+            int need_lo = co.y0[i0];
+            int need_hi = co.y1[i1 - 1];
+            ImageView* dst = &band[b % n_buf];
+
+            // Baris yang masih dipakai (overlap dengan band sebelumnya) digeser ke depan
+            int keep = 0;
+            int first_new = need_lo;
+            if (need_lo >= lo && need_lo <= hi) {
+                keep = hi - need_lo + 1;
+                memmove(strip.data, view_row(&strip, need_lo - lo), (size_t)keep * src_row);
+                first_new = hi + 1;
+            }
+            // Baris baru kontigu di file: satu pread
+            if (need_hi >= first_new) {
+                size_t nbytes = (size_t)(need_hi - first_new + 1) * src_row;
+                off_t offset = (off_t)h.header_len + (off_t)first_new * (off_t)src_row;
+                if (pread_full(fd, view_row(&strip, keep), nbytes, offset) != 0) {
+                    printf("❌ Error: Input terpotong (baris %d)\n", first_new);
+                    read_ok = 0;
+                    break;
+                }
+                if (bit_depth == 16) {
+                    // File big-endian -> native (in-place)
+                    unsigned char* p = view_row(&strip, keep);
+                    for (size_t k = 0; k < nbytes; k += 2) {
+                        uint16_t v = (uint16_t)(p[k] << 8 | p[k + 1]);
+                        memcpy(p + k, &v, 2);
+                    }
+                }
+                stats->bytes_read += nbytes;
+            }
+            lo = need_lo;
+            hi = need_hi;
+
+            // Hitung band b (berjalan bersamaan dengan task tulis band b-1)
+            #pragma omp taskloop num_tasks(num_threads)
+            for (int i = i0; i < i1; i++) {
+                row_kernel(view_row(&strip, co.y0[i] - lo), view_row(&strip, co.y1[i] - lo),
+                           view_row(dst, i - i0), &co, i);
+            }
+
+            if (overlap) {
+                // Tunggu tulis band b-1 selesai sebelum buffernya dipakai lagi
+                #pragma omp taskwait
+                if (write_failed) {
+                    write_ok = 0;
+                    break;
+                }
+                #pragma omp task firstprivate(dst, i0, i1, b) shared(write_failed)
+                {
+                    if (write_rows_fd(out, dst, 0, i1 - i0, header, b == 0 ? (size_t)hlen : 0) != 0) {
+                        write_failed = 1;
+                    }
+                }
+            } else if (write_rows_fd(out, dst, 0, i1 - i0, header, b == 0 ? (size_t)hlen : 0) != 0) {
+                write_ok = 0;
+            }
+        }
+        #pragma omp taskwait
+        if (write_failed) write_ok = 0;
+    }
+
+    int ok = read_ok && write_ok;
+    if (close(out) != 0) ok = 0;
+    pool_free(strip.data);
+    for (int k = 0; k < n_buf; k++) image_view_free(&band[k]);
+    resize_coeffs_free(&co);
+    close(fd);
+    return ok ? 0 : -1;
+}
+
+/*
+ * ==================== Emit progresif (PNG / PAM ke pipe) ====================
+ * Hasil resize dihitung per band baris dan setiap band langsung ditulis ke fd
+ * (mis. stdout yang di-pipe server HTTP) begitu selesai: byte pertama keluar
+ * setelah band pertama, bukan setelah seluruh citra + encode PNG, dan citra
+ * hasil penuh tidak pernah ada di memori.
+ * PAM: header P7 lalu baris mentah. PNG: satu stream zlib; setiap band
+ * di-deflate dengan Z_SYNC_FLUSH dan dikirim sebagai chunk IDAT sendiri,
+ * sehingga decoder progresif (browser) bisa menampilkan baris yang sudah tiba.
+ * Band b-1 di-encode + ditulis (task) sementara band b dihitung.
+ */
+#define EMIT_OUT_BYTES (64 * 1024) // buffer output deflate = ukuran maksimum satu IDAT
+
+typedef enum {
+    EMIT_PNG = 0,
+    EMIT_PAM
+} EmitFormat;
+
+typedef struct {
+    int fd;
+    EmitFormat format;
+    int level;
+    z_stream zs;
+    size_t row_bytes;
+    int bpp;
+    int rows_done;
+    unsigned char* prev;     // baris sebelumnya (urutan byte file) untuk filter PNG
+    unsigned char* be;       // baris 16-bit yang sudah big-endian
+    unsigned char* filtered; // satu band terfilter (byte filter + baris)
+    unsigned char* out;      // data IDAT hasil deflate
+    size_t bytes_written;
+} EmitState;
+
+static int emit_write(EmitState* e, const void* buf, size_t len) {
+    const unsigned char* p = buf;
+    e->bytes_written += len;
+    while (len > 0) {
+        ssize_t n = write(e->fd, p, len);
+        if (n < 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// Satu chunk PNG langsung ke fd: length + type, data, crc (tanpa menyalin data)
+static int emit_chunk(EmitState* e, const char* type, const unsigned char* data, size_t len) {
+    unsigned char head[8], tail[4];
+    write_be32(head, (uint32_t)len);
+    memcpy(head + 4, type, 4);
+    uLong crc = crc32(0L, head + 4, 4);
+    if (len) crc = crc32(crc, data, (uInt)len); // crc32(crc, NULL, 0) = nilai awal, bukan crc
+    write_be32(tail, (uint32_t)crc);
+    struct iovec iov[3] = {
+        { head, 8 }, { (void*)data, len }, { tail, 4 }
+    };
+    e->bytes_written += len + 12;
+    return writev_all(e->fd, iov, 3);
+}
+
+/*
+ * Filter + deflate satu band dan kirim output-nya. Band bukan-terakhir diakhiri
+ * Z_SYNC_FLUSH supaya semua baris band ini bisa di-decode penerima sekarang.
+ */
+static int emit_png_band(EmitState* e, const ImageView* band, int rows, int last) {
+    for (int y = 0; y < rows; y++) {
+        const unsigned char* row = view_row(band, y);
+        if (band->bit_depth == 16) {
+            store_be16(e->be, row, e->row_bytes / 2);
+            row = e->be;
+        }
+        png_filter_row(row, e->rows_done + y > 0 ? e->prev : NULL, e->row_bytes, e->bpp,
+                       e->level, e->filtered + (size_t)y * (e->row_bytes + 1));
+        memcpy(e->prev, row, e->row_bytes);
+    }
+    e->rows_done += rows;
+
+    e->zs.next_in = e->filtered;
+    e->zs.avail_in = (uInt)((size_t)rows * (e->row_bytes + 1));
+    int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+    do {
+        e->zs.next_out = e->out;
+        e->zs.avail_out = EMIT_OUT_BYTES;
+        if (deflate(&e->zs, flush) == Z_STREAM_ERROR) return -1;
+        size_t n = EMIT_OUT_BYTES - e->zs.avail_out;
+        if (n && emit_chunk(e, "IDAT", e->out, n) != 0) return -1;
+    } while (e->zs.avail_out == 0);
+    return last ? emit_chunk(e, "IEND", NULL, 0) : 0;
+}
+
+static int emit_band(EmitState* e, const ImageView* band, int rows, int last) {
+    if (e->format == EMIT_PAM) {
+        int ret = write_rows_fd(e->fd, band, 0, rows, NULL, 0);
+        e->bytes_written += (size_t)rows * e->row_bytes;
+        return ret;
+    }
+    return emit_png_band(e, band, rows, last);
+}
+
+/*
+ * Resize src dengan skala tertentu dan tulis hasilnya progresif ke fd.
+ * level: deflate 0..9 (PNG). Return 0 jika sukses, -1 jika gagal (mis. pipe ditutup).
+ */
+int emit_resize(const ImageView* src, int fd, EmitFormat format, double scale,
+                KernelMode mode, int num_threads, int level, StreamStats* stats)
+{
+    int ch = src->channels;
+    int bit_depth = src->bit_depth;
+    size_t px = pixel_bytes(ch, bit_depth);
+    if (level < 0) level = 0;
+    if (level > 9) level = 9;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->src_w = src->width;
+    stats->src_h = src->height;
+    stats->channels = ch;
+    stats->bit_depth = bit_depth;
+    resize_target_dims(src->width, src->height, scale, &stats->new_w, &stats->new_h);
+    int new_w = stats->new_w;
+    int new_h = stats->new_h;
+
+    ResizeCoeffs co;
+    if (resize_coeffs_build(&co, src->width, src->height, new_w, new_h, ch, bit_depth) != 0) {
+        return -1;
+    }
+    resize_row_fn row_kernel = select_row_kernel(mode, ch, bit_depth);
+
+    // Band kecil = byte pertama lebih cepat; dibatasi juga oleh data mentah per band PNG
+    size_t row_bytes = (size_t)new_w * px;
+    int band_h = plan_band_height(src->width, src->height, new_w, new_h, (int)px, num_threads);
+    int max_h = (int)(PNG_BAND_MIN_BYTES / row_bytes);
+    if (band_h > max_h) band_h = max_h > 0 ? max_h : 1;
+    int n_bands = (new_h + band_h - 1) / band_h;
+    stats->band_h = band_h;
+
+    EmitState e;
+    memset(&e, 0, sizeof(e));
+    e.fd = fd;
+    e.format = format;
+    e.level = level;
+    e.row_bytes = row_bytes;
+    e.bpp = (int)px;
+
+    ImageView band[2] = { { 0 }, { 0 } };
+    int ok = image_view_alloc(&band[0], new_w, band_h, ch, bit_depth) == 0 &&
+             image_view_alloc(&band[1], new_w, band_h, ch, bit_depth) == 0;
+    if (ok && format == EMIT_PNG) {
+        e.prev = pool_alloc(row_bytes);
+        e.be = pool_alloc(row_bytes);
+        e.filtered = pool_alloc((size_t)band_h * (row_bytes + 1));
+        e.out = pool_alloc(EMIT_OUT_BYTES);
+        ok = e.prev && e.be && e.filtered && e.out && deflateInit(&e.zs, level) == Z_OK;
+    }
+    stats->peak_bytes = 2 * band[0].stride * band_h + (size_t)new_h * 3 * sizeof(int) +
+                        (size_t)co.n_elems * 3 * sizeof(int) +
+                        (format == EMIT_PNG ? (size_t)band_h * (row_bytes + 1) + EMIT_OUT_BYTES : 0);
+
+    // Header dikirim sebelum resize dimulai
+    if (ok && format == EMIT_PNG) {
+        unsigned char ihdr[13];
+        write_be32(ihdr, (uint32_t)new_w);
+        write_be32(ihdr + 4, (uint32_t)new_h);
+        ihdr[8] = (unsigned char)bit_depth;
+        ihdr[9] = (unsigned char)(ch == 1 ? 0 : ch == 3 ? 2 : 6);
+        ihdr[10] = ihdr[11] = ihdr[12] = 0;
+        ok = emit_write(&e, PNG_SIGNATURE, 8) == 0 && emit_chunk(&e, "IHDR", ihdr, 13) == 0;
+    } else if (ok) {
+        static const char* const tupltype[] = { "", "GRAYSCALE", "GRAYSCALE_ALPHA", "RGB", "RGB_ALPHA" };
+        char header[128];
+        int hlen = snprintf(header, sizeof(header),
+                            "P7\nWIDTH %d\nHEIGHT %d\nDEPTH %d\nMAXVAL %d\nTUPLTYPE %s\nENDHDR\n",
+                            new_w, new_h, ch, bit_depth == 16 ? 65535 : 255, tupltype[ch]);
+        ok = emit_write(&e, header, (size_t)hlen) == 0;
+    }
+
+    if (ok) {
+        #pragma omp parallel num_threads(num_threads)
+        #pragma omp single
+        {
+            // Status task emit: ditulis task, dibaca hanya setelah taskwait (tanpa race
+            // dengan kondisi loop yang berjalan bersamaan dengan task tsb)
+            int emit_failed = 0;
+            for (int b = 0; b < n_bands; b++) {
+                int i0 = b * band_h;
+                int i1 = i0 + band_h < new_h ? i0 + band_h : new_h;
+                ImageView* dst = &band[b % 2];
+
+                // Hitung band b (berjalan bersamaan dengan task encode + tulis band b-1)
+                #pragma omp taskloop num_tasks(num_threads)
+                for (int i = i0; i < i1; i++) {
+                    row_kernel(view_row(src, co.y0[i]), view_row(src, co.y1[i]),
+                               view_row(dst, i - i0), &co, i);
+                }
+
+                // Tunggu band b-1 selesai ditulis sebelum band b dikirim (urutan stream)
+                #pragma omp taskwait
+                if (emit_failed) break;
+                #pragma omp task firstprivate(dst, i0, i1, b) shared(emit_failed)
+                {
+                    if (emit_band(&e, dst, i1 - i0, b == n_bands - 1) != 0) emit_failed = 1;
+                }
+            }
+            #pragma omp taskwait
+            if (emit_failed) ok = 0;
+        }
+    }
+    stats->bytes_written = e.bytes_written;
+
+    if (format == EMIT_PNG && e.zs.state) deflateEnd(&e.zs);
+    pool_free(e.prev);
+    pool_free(e.be);
+    pool_free(e.filtered);
+    pool_free(e.out);
+    image_view_free(&band[0]);
+    image_view_free(&band[1]);
+    resize_coeffs_free(&co);
+    return ok ? 0 : -1;
+}
+
+/*
+ * ==================== Pyramid (multi-resolusi, satu pass) ====================
+ * Semua skala dihitung dalam satu pass atas sumber: sumber dibagi menjadi band
+ * baris yang muat di L2, dan untuk setiap band dihitung baris output SEMUA level
+ * yang baris sumber atasnya (y0) ada di band tsb. Sumber hanya dialirkan dari
+ * memori sekali, bukan sekali per skala.
+ *
+ * Level tidak diturunkan dari level lain: bilinear downscale adalah sampling titik,
+ * jadi resize kedua atas level yang sudah di-interpolasi menyimpang jauh dari resize
+ * langsung (gantrycrane 0.25x dari 0.5x: PSNR ~27 dB). Setiap level dihitung dari
+ * sumber dan bit-identik dengan resize terpisah.
+ */
+#define PYRAMID_MAX_LEVELS 16
+
+typedef struct {
+    double scale;
+    ImageView out;
+    ResizeCoeffs co;
+} PyramidLevel;
+
+static void pyramid_levels_free(PyramidLevel* lv, int n) {
+    for (int l = 0; l < n; l++) {
+        image_view_free(&lv[l].out);
+        resize_coeffs_free(&lv[l].co);
+    }
+}
+
+/*
+ * Hitung semua level; lv[].scale harus sudah terisi (diurutkan dari yang terbesar)
+ */
+int build_pyramid(const ImageView* src, PyramidLevel* lv, int n,
+                  int num_threads, KernelMode mode)
+{
+    for (int a = 1; a < n; a++) {
+        for (int b = a; b > 0 && lv[b].scale > lv[b - 1].scale; b--) {
+            PyramidLevel t = lv[b]; lv[b] = lv[b - 1]; lv[b - 1] = t;
+        }
+    }
+
+    int ch = src->channels;
+    size_t px = pixel_bytes(ch, src->bit_depth);
+    size_t out_row_bytes = 0;
+    for (int l = 0; l < n; l++) {
+        int new_w, new_h;
+        resize_target_dims(src->width, src->height, lv[l].scale, &new_w, &new_h);
+        if (image_view_alloc(&lv[l].out, new_w, new_h, ch, src->bit_depth) != 0 ||
+            resize_coeffs_build(&lv[l].co, src->width, src->height, new_w, new_h,
+                                ch, src->bit_depth) != 0) {
+            pyramid_levels_free(lv, l + 1);
+            return -1;
+        }
+        out_row_bytes += (size_t)new_w * px;
+    }
+
+    // Tinggi band sumber: strip sumber + baris output semua level muat di L2/2
+    size_t src_row = view_row_bytes(src);
+    int band_h = plan_band_height(src->width, src->height, src->width, src->height,
+                                  (int)px, num_threads);
+    size_t per_row = src_row + out_row_bytes;
+    while (band_h > 1 && (size_t)band_h * per_row > l2_cache_bytes() / 2) band_h /= 2;
+    int n_bands = (src->height + band_h - 1) / band_h;
+
+    // Baris output pertama tiap level per band (y0 monoton naik)
+    int* first = malloc((size_t)n * (n_bands + 1) * sizeof(int));
+    if (!first) {
+        pyramid_levels_free(lv, n);
+        return -1;
+    }
+    for (int l = 0; l < n; l++) {
+        int* f = first + (size_t)l * (n_bands + 1);
+        int i = 0;
+        for (int b = 0; b <= n_bands; b++) {
+            while (i < lv[l].co.new_h && lv[l].co.y0[i] < b * band_h) i++;
+            f[b] = i;
+        }
+        f[n_bands] = lv[l].co.new_h;
+    }
+
+    resize_row_fn row_kernel = select_row_kernel(mode, src->channels, src->bit_depth);
+
+    #pragma omp parallel for schedule(static) num_threads(num_threads)
+    for (int b = 0; b < n_bands; b++) {
+        for (int l = 0; l < n; l++) {
+            const int* f = first + (size_t)l * (n_bands + 1);
+            PyramidLevel* L = &lv[l];
+            for (int i = f[b]; i < f[b + 1]; i++) {
+                row_kernel(view_row(src, L->co.y0[i]), view_row(src, L->co.y1[i]),
+                           view_row(&L->out, i), &L->co, i);
+            }
+        }
+    }
+    free(first);
+    return 0;
+}
+
+/*
+ * Parse daftar skala "0.25,0.5,1.5,2" (dipakai --pyramid dan --bench-scales);
+ * mengembalikan jumlah skala valid
+ */
+static int parse_scale_list(const char* text, double* scales, int max_scales) {
+    int n = 0;
+    const char* p = text;
+    while (*p && n < max_scales) {
+        char* end;
+        double s = strtod(p, &end);
+        if (end == p) break;
+        if (s > 0.0 && s <= 10.0) scales[n++] = s;
+        p = *end == ',' ? end + 1 : end;
+        if (*end != ',') break;
+    }
+    return n;
+}
+
+/*
+ * ==================== Batch resize (pipeline) ====================
+ * Satu proses memproses banyak gambar dari manifest. Tim thread OpenMP dibuat
+ * sekali dan dipakai ulang; buffer output & tabel koefisien per slot pipeline
+ * juga dipakai ulang antar gambar. Decode gambar k, resize gambar k-1 dan
+ * encode gambar k-2 berjalan bersamaan sebagai task.
+ *
+ * Format manifest (satu job per baris, '#' = komentar):
+ *   input  skala|LEBARxTINGGI  output(.png|.ppm)
+ * Contoh: "foto.png 0.25 thumb.png" atau "foto.png 320x0 thumb.png"
+ * (0 pada salah satu dimensi = ikuti rasio aspek).
+ */
+#define BATCH_SLOTS 3
+
+typedef struct {
+    char input[512];
+    char output[512];
+    double scale;      // dipakai jika target_w == target_h == 0
+    int target_w, target_h;
+
+    int ok;
+    int src_w, src_h, new_w, new_h;
+    double t_decode, t_resize, t_encode; // durasi per tahap
+    double t_ready, t_done;              // untuk latensi end-to-end
+} BatchJob;
+
+typedef struct {
+    Image* src;
+    ImageView out;
+    size_t out_cap;     // kapasitas byte buffer out (grow-only)
+    ResizeCoeffs co;
+    int co_valid;
+} BatchSlot;
+
+static int parse_batch_size(const char* text, BatchJob* job) {
+    int w = 0, h = 0;
+    job->target_w = job->target_h = 0;
+    job->scale = 0.0;
+    if (sscanf(text, "%dx%d", &w, &h) == 2 && strchr(text, 'x')) {
+        if (w < 0 || h < 0 || (w == 0 && h == 0)) return -1;
+        job->target_w = w;
+        job->target_h = h;
+        return 0;
+    }
+    job->scale = atof(text);
+    return job->scale > 0.0 ? 0 : -1;
+}
+
+/*
+ * Baca manifest; mengembalikan jumlah job (atau -1 jika file tidak bisa dibuka)
+ */
+static int load_batch_manifest(const char* path, BatchJob** jobs_out) {
+    FILE* f = fopen(path, "r");
+    if (!f) return -1;
+    int cap = 16, n = 0;
+    BatchJob* jobs = malloc(cap * sizeof(BatchJob));
+    char line[1200];
+    int lineno = 0;
+    while (jobs && fgets(line, sizeof(line), f)) {
+        lineno++;
+        char in[512], size[64], out[512];
+        char* p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\0') continue;
+        if (sscanf(p, "%511s %63s %511s", in, size, out) != 3) {
+            printf("⚠️  Manifest baris %d dilewati (format: input skala|WxH output)\n", lineno);
+            continue;
+        }
+        if (n == cap) {
+            cap *= 2;
+            BatchJob* grown = realloc(jobs, cap * sizeof(BatchJob));
+            if (!grown) break;
+            jobs = grown;
+        }
+        memset(&jobs[n], 0, sizeof(BatchJob));
+        if (parse_batch_size(size, &jobs[n]) != 0) {
+            printf("⚠️  Manifest baris %d: ukuran '%s' tidak valid\n", lineno, size);
+            continue;
+        }
+        snprintf(jobs[n].input, sizeof(jobs[n].input), "%s", in);
+        snprintf(jobs[n].output, sizeof(jobs[n].output), "%s", out);
+        n++;
+    }
+    fclose(f);
+    *jobs_out = jobs;
+    return jobs ? n : -1;
+}
+
+static int has_suffix(const char* s, const char* suffix) {
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcasecmp(s + n - m, suffix) == 0;
+}
+
+static void batch_decode(BatchJob* job, BatchSlot* slot) {
+    double t0 = omp_get_wtime();
+    const char* kind;
+    slot->src = load_image_file(job->input, &kind);
+    job->ok = slot->src != NULL;
+    if (job->ok) {
+        job->src_w = slot->src->width;
+        job->src_h = slot->src->height;
+        if (job->target_w || job->target_h) {
+            job->new_w = job->target_w ? job->target_w
+                                       : (int)((double)job->src_w * job->target_h / job->src_h + 0.5);
+            job->new_h = job->target_h ? job->target_h
+                                       : (int)((double)job->src_h * job->target_w / job->src_w + 0.5);
+            if (job->new_w < 1) job->new_w = 1;
+            if (job->new_h < 1) job->new_h = 1;
+        } else {
+            resize_target_dims(job->src_w, job->src_h, job->scale, &job->new_w, &job->new_h);
+        }
+    }
+    job->t_decode = omp_get_wtime() - t0;
+}
+
+static void batch_resize(BatchJob* job, BatchSlot* slot, KernelMode mode, int num_threads) {
+    double t0 = omp_get_wtime();
+    ImageView src = image_view_of(slot->src);
+
+    // Buffer output & tabel koefisien dipakai ulang jika cukup / dimensi sama
+    size_t row_bytes = (size_t)job->new_w * pixel_bytes(src.channels, src.bit_depth);
+    size_t stride = (row_bytes + IMAGE_ALIGN - 1) & ~(size_t)(IMAGE_ALIGN - 1);
+    size_t need = stride * job->new_h;
+    if (need > slot->out_cap) {
+        pool_free(slot->out.data);
+        slot->out.data = pool_alloc(need);
+        slot->out_cap = slot->out.data ? need : 0;
+    }
+    slot->out.width = job->new_w;
+    slot->out.height = job->new_h;
+    slot->out.channels = src.channels;
+    slot->out.bit_depth = src.bit_depth;
+    slot->out.stride = stride;
+
+    ResizeCoeffs* co = &slot->co;
+    if (!slot->co_valid || co->src_w != src.width || co->src_h != src.height ||
+        co->new_w != job->new_w || co->new_h != job->new_h ||
+        co->channels != src.channels || co->bit_depth != src.bit_depth) {
+        if (slot->co_valid) resize_coeffs_free(co);
+        slot->co_valid = resize_coeffs_build(co, src.width, src.height, job->new_w, job->new_h,
+                                             src.channels, src.bit_depth) == 0;
+    }
+    if (!slot->out.data || !slot->co_valid) {
+        job->ok = 0;
+    } else {
+        resize_row_fn row_kernel = select_row_kernel(mode, src.channels, src.bit_depth);
+        ImageView* dst = &slot->out;
+        #pragma omp taskloop num_tasks(num_threads * 2)
+        for (int i = 0; i < job->new_h; i++) {
+            row_kernel(view_row(&src, co->y0[i]), view_row(&src, co->y1[i]),
+                       view_row(dst, i), co, i);
+        }
+    }
+    image_discard(slot->src);
+    slot->src = NULL;
+    job->t_resize = omp_get_wtime() - t0;
+}
+
+static void batch_encode(BatchJob* job, BatchSlot* slot, int png_level) {
+    double t0 = omp_get_wtime();
+    int ret;
+    if (has_suffix(job->output, ".png")) {
+        ret = write_png(job->output, &slot->out, png_level);
+    } else {
+        ret = write_ppm_file(job->output, &slot->out);
+    }
+    if (ret != 0) job->ok = 0;
+    job->t_encode = omp_get_wtime() - t0;
+}
+
+/*
+ * Jalankan semua job sebagai pipeline 3 tahap; mengembalikan jumlah job sukses
+ */
+int run_batch(BatchJob* jobs, int n, KernelMode mode, int num_threads, int png_level) {
+    BatchSlot slots[BATCH_SLOTS];
+    memset(slots, 0, sizeof(slots));
+    size_t fresh0 = buffer_pool.fresh, reused0 = buffer_pool.reused;
+    double t_start = omp_get_wtime();
+
+    #pragma omp parallel num_threads(num_threads)
+    #pragma omp single
+    {
+        for (int step = 0; step < n + 2; step++) {
+            int d = step, r = step - 1, e = step - 2;
+            if (d < n) {
+                #pragma omp task firstprivate(d)
+                {
+                    jobs[d].t_ready = omp_get_wtime();
+                    batch_decode(&jobs[d], &slots[d % BATCH_SLOTS]);
+                }
+            }
+            if (r >= 0 && r < n && jobs[r].ok) {
+                #pragma omp task firstprivate(r)
+                batch_resize(&jobs[r], &slots[r % BATCH_SLOTS], mode, num_threads);
+            }
+            if (e >= 0 && jobs[e].ok) {
+                #pragma omp task firstprivate(e)
+                {
+                    batch_encode(&jobs[e], &slots[e % BATCH_SLOTS], png_level);
+                    jobs[e].t_done = omp_get_wtime();
+                }
+            }
+            #pragma omp taskwait
+        }
+    }
+    double total = omp_get_wtime() - t_start;
+
+    for (int k = 0; k < BATCH_SLOTS; k++) {
+        image_discard(slots[k].src);
+        pool_free(slots[k].out.data);
+        if (slots[k].co_valid) resize_coeffs_free(&slots[k].co);
+    }
+
+    // Ringkasan: throughput & latensi per tahap
+    int ok = 0;
+    double sum_d = 0, sum_r = 0, sum_e = 0, sum_lat = 0, max_lat = 0, mpix = 0;
+    for (int k = 0; k < n; k++) {
+        BatchJob* j = &jobs[k];
+        if (!j->ok) {
+            printf("  [%d] %s -> %s: GAGAL\n", k + 1, j->input, j->output);
+            continue;
+        }
+        double lat = j->t_done - j->t_ready;
+        printf("  [%d] %s (%dx%d) -> %s (%dx%d): decode %.2f ms, resize %.2f ms, encode %.2f ms\n",
+               k + 1, j->input, j->src_w, j->src_h, j->output, j->new_w, j->new_h,
+               j->t_decode * 1e3, j->t_resize * 1e3, j->t_encode * 1e3);
+        ok++;
+        sum_d += j->t_decode;
+        sum_r += j->t_resize;
+        sum_e += j->t_encode;
+        sum_lat += lat;
+        if (lat > max_lat) max_lat = lat;
+        mpix += (double)j->new_w * j->new_h / 1e6;
+    }
+    printf("\n--- RINGKASAN BATCH ---\n");
+    printf("Gambar sukses: %d / %d, %d threads\n", ok, n, num_threads);
+    printf("Waktu total: %.4f detik\n", total);
+    printf("Throughput: %.2f gambar/detik (%.2f MPix output/detik)\n",
+           total > 0 ? ok / total : 0.0, total > 0 ? mpix / total : 0.0);
+    if (ok > 0) {
+        printf("Rata-rata per tahap: decode %.2f ms, resize %.2f ms, encode %.2f ms\n",
+               sum_d / ok * 1e3, sum_r / ok * 1e3, sum_e / ok * 1e3);
+        printf("Latensi end-to-end: rata-rata %.2f ms, maks %.2f ms\n",
+               sum_lat / ok * 1e3, max_lat * 1e3);
+    }
+    // Steady state: setelah beberapa job pertama, semua buffer berasal dari free list
+    printf("Buffer pool: %zu alokasi baru, %zu dipakai ulang (%.2f MB menganggur di pool)\n",
+           buffer_pool.fresh - fresh0, buffer_pool.reused - reused0,
+           buffer_pool.bytes_cached / 1e6);
+    return ok;
+}
+
+void free_image_struct(Image* img) {
+    if (img) {
+        if (img->data) pool_free(img->data);
         free(img);
-        return NULL;
     }
-    
-    // Skip whitespace
-    int c;
-    while ((c = fgetc(f)) != EOF && (c == ' ' || c == '\n' || c == '\t' || c == '#')) {
-        if (c == '#') {
-            while ((c = fgetc(f)) != EOF && c != '\n');
+}
+
+/*
+ * ==================== Verifikasi (hash per band, paralel) ====================
+ * Citra dibagi band baris (~VERIFY_BAND_BYTES, hanya bergantung pada dimensi),
+ * setiap band di-hash 64-bit (gaya XXH64) secara paralel. Dua citra dianggap
+ * sama jika semua digest band sama. Digest referensi cukup dihitung sekali dan
+ * dipakai untuk membandingkan semua hasil paralel. Padding stride tidak ikut di-hash.
+ */
+#define VERIFY_BAND_BYTES (256 * 1024)
+
+#define HASH_P1 0x9E3779B185EBCA87ULL
+#define HASH_P2 0xC2B2AE3D27D4EB4FULL
+#define HASH_P3 0x165667B19E3779F9ULL
+#define HASH_P4 0x85EBCA77C2B2AE63ULL
+#define HASH_P5 0x27D4EB2F165667C5ULL
+
+typedef struct {
+    int width, height, channels, bit_depth;
+    int band_h, n_bands;
+    uint64_t* band_hash;
+} ImageDigest;
+
+typedef struct {
+    int max_abs_err;   // dalam LSB sesuai bit depth
+    double mse;
+    double psnr;       // dB; INFINITY jika identik
+} ImageQuality;
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t load_u64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t hash_round(uint64_t acc, uint64_t in) {
+    acc += in * HASH_P2;
+    return rotl64(acc, 31) * HASH_P1;
+}
+
+/*
+ * Hash 64-bit (XXH64 tanpa kompatibilitas endian) dari n byte
+ */
+static uint64_t hash64(const unsigned char* p, size_t n, uint64_t seed) {
+    const unsigned char* end = p + n;
+    uint64_t h;
+    if (n >= 32) {
+        uint64_t v1 = seed + HASH_P1 + HASH_P2, v2 = seed + HASH_P2;
+        uint64_t v3 = seed, v4 = seed - HASH_P1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = hash_round(v1, load_u64(p));
+            v2 = hash_round(v2, load_u64(p + 8));
+            v3 = hash_round(v3, load_u64(p + 16));
+            v4 = hash_round(v4, load_u64(p + 24));
         }
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = (h ^ hash_round(0, v1)) * HASH_P1 + HASH_P4;
+        h = (h ^ hash_round(0, v2)) * HASH_P1 + HASH_P4;
+        h = (h ^ hash_round(0, v3)) * HASH_P1 + HASH_P4;
+        h = (h ^ hash_round(0, v4)) * HASH_P1 + HASH_P4;
+    } else {
+        h = seed + HASH_P5;
     }
-    ungetc(c, f);
-    
-    // Baca width, height, maxval
-    int maxval;
-    fscanf(f, "%d %d %d", &img->width, &img->height, &maxval);
-    fgetc(f); // skip whitespace
-    
-    img->channels = 3; // RGB - KEEP COLOR
-    img->data = malloc(img->width * img->height * 3 * sizeof(unsigned char));
-    
-    // Read RGB data langsung (tanpa konversi grayscale)
-    fread(img->data, 1, img->width * img->height * 3, f);
-    
-    fclose(f);
-    
-    // Cleanup temporary file
-    snprintf(command, sizeof(command), "rm -f %s", ppm_temp);
-    system(command);
-    
-    printf("✅ Berhasil membaca PNG: %dx%d (RGB Color)\n", img->width, img->height);
-    return img;
+    h += (uint64_t)n;
+    for (; p + 8 <= end; p += 8) {
+        h ^= hash_round(0, load_u64(p));
+        h = rotl64(h, 27) * HASH_P1 + HASH_P4;
+    }
+    for (; p < end; p++) {
+        h ^= (uint64_t)*p * HASH_P5;
+        h = rotl64(h, 11) * HASH_P1;
+    }
+    h ^= h >> 33;
+    h *= HASH_P2;
+    h ^= h >> 29;
+    h *= HASH_P3;
+    h ^= h >> 32;
+    return h;
+}
+
+void image_digest_free(ImageDigest* d) {
+    free(d->band_hash);
+    d->band_hash = NULL;
+    d->n_bands = 0;
 }
 
 /*
- * Tulis hasil ke file PPM (RGB Color)
+ * Hitung digest per band secara paralel; return 0 jika sukses
  */
-void write_ppm(const char* filename, unsigned char** img, int height, int width) {
-    FILE* f = fopen(filename, "wb");
-    fprintf(f, "P6\n%d %d\n255\n", width, height);
-    
-    for (int i = 0; i < height; i++) {
-        for (int j = 0; j < width; j++) {
-            // img[i][j] adalah pointer ke RGB data (3 bytes)
-            unsigned char* rgb = (unsigned char*)(img[i] + j * 3);
-            fputc(rgb[0], f); // R
-            fputc(rgb[1], f); // G
-            fputc(rgb[2], f); // B
+int image_digest(const ImageView* img, ImageDigest* d) {
+    size_t row_bytes = view_row_bytes(img);
+    d->width = img->width;
+    d->height = img->height;
+    d->channels = img->channels;
+    d->bit_depth = img->bit_depth;
+    d->band_h = row_bytes ? (int)(VERIFY_BAND_BYTES / row_bytes) : 1;
+    if (d->band_h < 1) d->band_h = 1;
+    d->n_bands = (img->height + d->band_h - 1) / d->band_h;
+    d->band_hash = malloc((size_t)(d->n_bands > 0 ? d->n_bands : 1) * sizeof(uint64_t));
+    if (!d->band_hash) return -1;
+
+    #pragma omp parallel for schedule(static) if (d->n_bands > 1)
+    for (int b = 0; b < d->n_bands; b++) {
+        int y_end = (b + 1) * d->band_h < img->height ? (b + 1) * d->band_h : img->height;
+        uint64_t h = (uint64_t)b;
+        for (int y = b * d->band_h; y < y_end; y++) {
+            h = hash64(view_row(img, y), row_bytes, h);
         }
+        d->band_hash[b] = h;
     }
-    fclose(f);
-    printf("✅ Hasil disimpan ke: %s\n", filename);
+    return 0;
+}
+
+int digest_equal(const ImageDigest* a, const ImageDigest* b) {
+    if (a->width != b->width || a->height != b->height ||
+        a->channels != b->channels || a->bit_depth != b->bit_depth ||
+        a->n_bands != b->n_bands) {
+        return 0;
+    }
+    return memcmp(a->band_hash, b->band_hash, (size_t)a->n_bands * sizeof(uint64_t)) == 0;
 }
 
 /*
- * Fungsi interpolasi bilinear untuk satu titik
+ * Bandingkan citra dengan digest referensi yang sudah dihitung
  */
-static inline double bilinear_interpolate(
-    double x, double y,
-    double Q11, double Q21, double Q12, double Q22)
-{
-    double fx1 = Q11 + (Q21 - Q11) * x;
-    double fx2 = Q12 + (Q22 - Q12) * x;
-    return fx1 + (fx2 - fx1) * y;
+int verify_against_digest(const ImageDigest* ref, const ImageView* img) {
+    ImageDigest d;
+    if (image_digest(img, &d) != 0) return 0;
+    int same = digest_equal(ref, &d);
+    image_digest_free(&d);
+    return same;
 }
 
 /*
- * VERSI SERIAL - Resize citra RGB menggunakan interpolasi bilinear
+ * Fungsi untuk memverifikasi hasil (membandingkan dua gambar lewat digest paralel)
  */
-unsigned char** bilinear_resize_serial(
-    unsigned char** src, int src_h, int src_w,
-    int new_h, int new_w)
-{
-    unsigned char** dst = malloc(new_h * sizeof(unsigned char*));
-    for (int i = 0; i < new_h; i++)
-        dst[i] = malloc(new_w * 3 * sizeof(unsigned char)); // 3 for RGB
+int verify_results(const ImageView* img1, const ImageView* img2) {
+    if (img1->width != img2->width || img1->height != img2->height ||
+        img1->channels != img2->channels || img1->bit_depth != img2->bit_depth) {
+        return 0;
+    }
+    ImageDigest d;
+    if (image_digest(img1, &d) != 0) return 0;
+    int same = verify_against_digest(&d, img2);
+    image_digest_free(&d);
+    return same;
+}
 
-    double x_ratio = (double)(src_w - 1) / (double)(new_w - 1);
-    double y_ratio = (double)(src_h - 1) / (double)(new_h - 1);
+/*
+ * Max |selisih| dan PSNR terhadap referensi (paralel per baris), untuk cek
+ * toleransi kernel fixed/SIMD. Return -1 jika format/dimensi berbeda.
+ */
+int image_quality(const ImageView* ref, const ImageView* img, ImageQuality* q) {
+    if (ref->width != img->width || ref->height != img->height ||
+        ref->channels != img->channels || ref->bit_depth != img->bit_depth) {
+        return -1;
+    }
+    size_t samples = (size_t)ref->width * ref->channels;
+    int max_diff = 0;
+    double sq_sum = 0.0;
 
-    // Loop SERIAL - tidak ada paralelisasi
-    for (int i = 0; i < new_h; i++) {
-        for (int j = 0; j < new_w; j++) {
-            double src_x = j * x_ratio;
-            double src_y = i * y_ratio;
+    #pragma omp parallel for schedule(static) reduction(max:max_diff) reduction(+:sq_sum)
+    for (int i = 0; i < ref->height; i++) {
+        const unsigned char* a = view_row(ref, i);
+        const unsigned char* b = view_row(img, i);
+        uint64_t row_sq = 0;
+        for (size_t k = 0; k < samples; k++) {
+            int d = ref->bit_depth == 16
+                        ? abs((int)((const uint16_t*)a)[k] - (int)((const uint16_t*)b)[k])
+                        : abs((int)a[k] - (int)b[k]);
+            if (d > max_diff) max_diff = d;
+            row_sq += (uint64_t)d * (uint64_t)d;
+        }
+        sq_sum += (double)row_sq;
+    }
+
+    double max_val = ref->bit_depth == 16 ? 65535.0 : 255.0;
+    q->max_abs_err = max_diff;
+    q->mse = samples && ref->height ? sq_sum / ((double)samples * ref->height) : 0.0;
+    q->psnr = q->mse > 0.0 ? 10.0 * log10(max_val * max_val / q->mse) : INFINITY;
+    return 0;
+}
 
-            int x1 = (int)src_x;
-            int y1 = (int)src_y;
-            
-            // Boundary check
-            if (x1 >= src_w - 1) x1 = src_w - 2;
-            if (y1 >= src_h - 1) y1 = src_h - 2;
-            if (x1 < 0) x1 = 0;
-            if (y1 < 0) y1 = 0;
-            
-            int x2 = x1 + 1;
-            int y2 = y1 + 1;
+/*
+ * ==================== Benchmark (--bench, output JSON) ====================
+ * Setiap varian dijalankan `warmup` kali tanpa diukur lalu `reps` kali diukur.
+ * Thread di-sweep 1..omp_get_max_threads() dan ukuran hasil di-sweep dari daftar
+ * skala. Output satu objek JSON di stdout (tanpa teks lain) agar bisa langsung
+ * di-parse oleh server.
+ */
+#define BENCH_MAX_SCALES 16
+#define BENCH_DEFAULT_REPS 10
+#define BENCH_DEFAULT_WARMUP 2
 
-            double dx = src_x - x1;
-            double dy = src_y - y1;
+typedef struct {
+    double min, median, p95, mean, stddev;
+} BenchStats;
 
-            // Process untuk setiap channel RGB
-            for (int c = 0; c < 3; c++) {
-                double Q11 = src[y1][x1 * 3 + c];
-                double Q21 = src[y1][x2 * 3 + c];
-                double Q12 = src[y2][x1 * 3 + c];
-                double Q22 = src[y2][x2 * 3 + c];
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
 
-                double val = bilinear_interpolate(dx, dy, Q11, Q21, Q12, Q22);
+static BenchStats bench_stats(double* t, int n) {
+    BenchStats st;
+    qsort(t, n, sizeof(double), compare_double);
+    st.min = t[0];
+    st.median = n % 2 ? t[n / 2] : 0.5 * (t[n / 2 - 1] + t[n / 2]);
+    int rank = (int)(0.95 * n + 0.999999); // nearest-rank p95
+    st.p95 = t[(rank < 1 ? 1 : rank) - 1];
+    double sum = 0.0;
+    for (int k = 0; k < n; k++) sum += t[k];
+    st.mean = sum / n;
+    double var = 0.0;
+    for (int k = 0; k < n; k++) var += (t[k] - st.mean) * (t[k] - st.mean);
+    st.stddev = n > 1 ? sqrt(var / (n - 1)) : 0.0;
+    return st;
+}
 
-                if (val < 0) val = 0;
-                if (val > 255) val = 255;
+/*
+ * Jalankan satu varian (threads == 0 -> versi serial) ke buffer milik pemanggil.
+ * dst dipakai ulang di setiap repetisi, jadi yang diukur hanya kernel + tabel
+ * koefisien (tanpa malloc/page fault output); isi dst = hasil run terakhir.
+ */
+static int bench_variant(const ImageView* src, ImageView* dst, int threads,
+                         KernelMode mode, int warmup, int reps, double* times)
+{
+    for (int r = 0; r < warmup + reps; r++) {
+        double t0 = omp_get_wtime();
+        int ret = threads == 0
+                      ? bilinear_resize_serial_into(src, dst, mode)
+                      : bilinear_resize_parallel_into(src, dst, threads, mode);
+        double t = omp_get_wtime() - t0;
+        if (ret != 0) return -1;
+        if (r >= warmup) times[r - warmup] = t;
+    }
+    return 0;
+}
 
-                dst[i][j * 3 + c] = (unsigned char)(val + 0.5);
-            }
+// String JSON (escape kutip, backslash & kontrol)
+static void print_json_string(const char* str) {
+    putchar('"');
+    for (const unsigned char* c = (const unsigned char*)str; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            printf("\\%c", *c);
+        } else if (*c < 0x20) {
+            printf("\\u%04x", *c);
+        } else {
+            putchar(*c);
         }
     }
-    return dst;
+    putchar('"');
+}
+
+static void bench_print_stats(const BenchStats* st, double mpix, double bytes) {
+    printf("\"min\": %.9f, \"median\": %.9f, \"p95\": %.9f, \"mean\": %.9f, \"stddev\": %.9f, "
+           "\"mpix_per_s\": %.3f, \"gb_per_s\": %.3f",
+           st->min, st->median, st->p95, st->mean, st->stddev,
+           mpix / st->median, bytes / st->median / 1e9);
 }
 
 /*
- * VERSI PARALEL - Resize citra RGB menggunakan OpenMP
+ * Byte yang dipindahkan per resize (untuk GB/s efektif): baris sumber yang
+ * benar-benar dibaca (unik) + seluruh output.
  */
-unsigned char** bilinear_resize_parallel(
-    unsigned char** src, int src_h, int src_w,
-    int new_h, int new_w, int num_threads)
+static double bench_bytes_moved(const ImageView* src, int new_h, int new_w) {
+    ResizeCoeffs co;
+    size_t px = pixel_bytes(src->channels, src->bit_depth);
+    double out_bytes = (double)new_w * new_h * px;
+    if (resize_coeffs_build(&co, src->width, src->height, new_w, new_h,
+                            src->channels, src->bit_depth) != 0) {
+        return out_bytes + (double)view_row_bytes(src) * src->height;
+    }
+    int rows = 0, last = -1;
+    for (int i = 0; i < new_h; i++) {
+        if (co.y0[i] > last) rows++;
+        if (co.y1[i] > co.y0[i] && co.y1[i] > last) rows++;
+        last = co.y1[i];
+    }
+    resize_coeffs_free(&co);
+    return out_bytes + (double)view_row_bytes(src) * rows;
+}
+
+int run_benchmark(const char* image_file, const ImageView* src, const double* scales,
+                  int n_scales, KernelMode mode, int warmup, int reps)
 {
-    unsigned char** dst = malloc(new_h * sizeof(unsigned char*));
-    for (int i = 0; i < new_h; i++)
-        dst[i] = malloc(new_w * 3 * sizeof(unsigned char)); // 3 for RGB
+    int max_threads = omp_get_max_threads();
+    double* times = malloc((size_t)reps * sizeof(double));
+    if (!times) return -1;
+    int ok = 1;
 
-    double x_ratio = (double)(src_w - 1) / (double)(new_w - 1);
-    double y_ratio = (double)(src_h - 1) / (double)(new_h - 1);
+    printf("{\n");
+    printf("  \"benchmark\": \"bilinear\",\n");
+    printf("  \"image\": ");
+    print_json_string(image_file);
+    printf(",\n");
+    printf("  \"source\": { \"width\": %d, \"height\": %d, \"channels\": %d, \"bit_depth\": %d },\n",
+           src->width, src->height, src->channels, src->bit_depth);
+    printf("  \"kernel\": \"%s\",\n", kernel_mode_name(mode));
+    printf("  \"isa\": \"%s\",\n", mode == KERNEL_SIMD ? isa_name(simd_isa) : "scalar");
+    printf("  \"warmup\": %d,\n", warmup);
+    printf("  \"repetitions\": %d,\n", reps);
+    printf("  \"max_threads\": %d,\n", max_threads);
+    printf("  \"l2_cache_bytes\": %zu,\n", l2_cache_bytes());
+    printf("  \"sizes\": [");
 
-    // Set jumlah thread untuk OpenMP
-    omp_set_num_threads(num_threads);
+    for (int s = 0; s < n_scales; s++) {
+        int new_w, new_h;
+        resize_target_dims(src->width, src->height, scales[s], &new_w, &new_h);
+        double mpix = (double)new_w * new_h / 1e6;
+        double bytes = bench_bytes_moved(src, new_h, new_w);
 
-    // Loop PARALEL menggunakan OpenMP
-    #pragma omp parallel for collapse(2) schedule(dynamic)
-    for (int i = 0; i < new_h; i++) {
-        for (int j = 0; j < new_w; j++) {
-            double src_x = j * x_ratio;
-            double src_y = i * y_ratio;
+        // Satu buffer referensi + satu buffer hasil, dipakai ulang oleh semua varian thread
+        ImageView reference = { 0 }, out = { 0 };
+        if (image_view_alloc(&reference, new_w, new_h, src->channels, src->bit_depth) != 0 ||
+            image_view_alloc(&out, new_w, new_h, src->channels, src->bit_depth) != 0 ||
+            bench_variant(src, &reference, 0, mode, warmup, reps, times) != 0) {
+            image_view_free(&out);
+            image_view_free(&reference);
+            ok = 0;
+            break;
+        }
+        BenchStats serial = bench_stats(times, reps);
+        ImageDigest ref_digest = { 0 };
+        if (image_digest(&reference, &ref_digest) != 0) ok = 0;
+
+        printf("%s\n    {\n", s ? "," : "");
+        printf("      \"scale\": %.4f, \"width\": %d, \"height\": %d, \"bytes_moved\": %.0f,\n",
+               scales[s], new_w, new_h, bytes);
+        printf("      \"serial\": { ");
+        bench_print_stats(&serial, mpix, bytes);
+        printf(" },\n");
+        printf("      \"parallel\": [");
+
+        for (int t = 1; t <= max_threads; t++) {
+            // Kosongkan dulu agar verifikasi tidak lolos karena sisa hasil varian sebelumnya
+            memset(out.data, 0, out.stride * out.height);
+            if (bench_variant(src, &out, t, mode, warmup, reps, times) != 0) {
+                ok = 0;
+                break;
+            }
+            BenchStats par = bench_stats(times, reps);
+            double t0 = omp_get_wtime();
+            int verified = ref_digest.band_hash && verify_against_digest(&ref_digest, &out);
+            double verify_s = omp_get_wtime() - t0;
+            if (!verified) ok = 0;
+
+            printf("%s\n        { \"threads\": %d, ", t > 1 ? "," : "", t);
+            bench_print_stats(&par, mpix, bytes);
+            printf(", \"speedup\": %.3f, \"efficiency\": %.2f, \"verified\": %s, \"verify_s\": %.9f }",
+                   serial.median / par.median, serial.median / par.median / t * 100.0,
+                   verified ? "true" : "false", verify_s);
+        }
+        printf("\n      ]\n    }");
+        image_digest_free(&ref_digest);
+        image_view_free(&out);
+        image_view_free(&reference);
+        fflush(stdout);
+    }
+    printf("\n  ],\n");
+    printf("  \"status\": \"%s\"\n", ok ? "success" : "error");
+    printf("}\n");
+    free(times);
+    return ok ? 0 : -1;
+}
 
-            int x1 = (int)src_x;
-            int y1 = (int)src_y;
-            
-            // Boundary check
-            if (x1 >= src_w - 1) x1 = src_w - 2;
-            if (y1 >= src_h - 1) y1 = src_h - 2;
-            if (x1 < 0) x1 = 0;
-            if (y1 < 0) y1 = 0;
-            
-            int x2 = x1 + 1;
-            int y2 = y1 + 1;
+/*
+ * ==================== Performance counter & roofline (--perf) ====================
+ * Setiap run kernel dibungkus counter hardware (perf_event_open, Linux):
+ * cycles, instructions, LLC miss. Counter dibuka, dibaca dan ditutup oleh setiap
+ * thread OpenMP (pid = 0, thread pemanggil) di dalam region paralel yang sama
+ * dengan resize yang diukur, lalu dijumlahkan, sehingga thread yang dihitung
+ * pasti thread yang bekerja. Bandwidth yang dicapai dibandingkan dengan puncak
+ * STREAM triad (diukur sekali per jumlah thread) di mesin yang sama.
+ */
+#define PERF_N_EVENTS 3
+#define PERF_MAX_THREADS 256
+#define STREAM_ARRAY_BYTES ((size_t)32 << 20) // per array, jauh di atas LLC umum
+#define STREAM_TRIALS 5
+#define CACHE_LINE_BYTES 64
 
-            double dx = src_x - x1;
-            double dy = src_y - y1;
+typedef struct {
+    uint64_t cycles;
+    uint64_t instructions;
+    uint64_t llc_misses;
+    int valid; // 0 jika perf_event_open tidak tersedia / ditolak
+} PerfCounts;
 
-            // Process untuk setiap channel RGB
-            for (int c = 0; c < 3; c++) {
-                double Q11 = src[y1][x1 * 3 + c];
-                double Q21 = src[y1][x2 * 3 + c];
-                double Q12 = src[y2][x1 * 3 + c];
-                double Q22 = src[y2][x2 * 3 + c];
+typedef struct {
+    int fd[PERF_N_EVENTS];
+} PerfThreadFds;
 
-                double val = bilinear_interpolate(dx, dy, Q11, Q21, Q12, Q22);
+#if defined(__linux__)
+static int perf_open_counter(uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1; // cukup perf_event_paranoid <= 2
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
 
-                if (val < 0) val = 0;
-                if (val > 255) val = 255;
+// Buka counter untuk thread pemanggil; fd = -1 jika gagal
+static void perf_open_self(PerfThreadFds* t) {
+#if defined(__linux__)
+    static const uint64_t events[PERF_N_EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES
+    };
+    for (int e = 0; e < PERF_N_EVENTS; e++) t->fd[e] = perf_open_counter(events[e]);
+#else
+    for (int e = 0; e < PERF_N_EVENTS; e++) t->fd[e] = -1;
+#endif
+}
 
-                dst[i][j * 3 + c] = (unsigned char)(val + 0.5);
-            }
+static void perf_start(PerfThreadFds* t) {
+    perf_open_self(t);
+#if defined(__linux__)
+    for (int e = 0; e < PERF_N_EVENTS; e++) {
+        if (t->fd[e] >= 0) {
+            ioctl(t->fd[e], PERF_EVENT_IOC_RESET, 0);
+            ioctl(t->fd[e], PERF_EVENT_IOC_ENABLE, 0);
         }
     }
-    return dst;
+#endif
+}
+
+// Hentikan, baca dan tutup counter thread pemanggil; tambahkan ke pc
+static void perf_stop(PerfThreadFds* t, PerfCounts* pc) {
+    uint64_t v[PERF_N_EVENTS] = { 0 };
+    for (int e = 0; e < PERF_N_EVENTS; e++) {
+        int fd = t->fd[e];
+        if (fd < 0) {
+            pc->valid = 0;
+            continue;
+        }
+#if defined(__linux__)
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+        if (read(fd, &v[e], sizeof(v[e])) != (ssize_t)sizeof(v[e])) pc->valid = 0;
+        close(fd);
+    }
+    pc->cycles += v[0];
+    pc->instructions += v[1];
+    pc->llc_misses += v[2];
 }
 
 /*
- * Konversi flat image ke 2D array untuk processing (RGB - 3 bytes per pixel)
+ * Puncak bandwidth memori ala STREAM triad (a = b + s * c), terbaik dari
+ * beberapa percobaan; byte dihitung seperti STREAM (3 array x 8 byte/elemen).
  */
-unsigned char** image_to_2d(unsigned char* data, int height, int width) {
-    unsigned char** img = malloc(height * sizeof(unsigned char*));
-    for (int i = 0; i < height; i++) {
-        img[i] = malloc(width * 3 * sizeof(unsigned char)); // 3 for RGB
-        memcpy(img[i], &data[i * width * 3], width * 3);
+static double stream_triad_peak(int threads) {
+    static double cached[PERF_MAX_THREADS + 1]; // per jumlah thread, diukur sekali
+    if (threads >= 1 && threads <= PERF_MAX_THREADS && cached[threads] > 0.0) return cached[threads];
+    size_t n = STREAM_ARRAY_BYTES / sizeof(double);
+    double* a = aligned_buffer_alloc(n * sizeof(double));
+    double* b = aligned_buffer_alloc(n * sizeof(double));
+    double* c = aligned_buffer_alloc(n * sizeof(double));
+    double best = 0.0;
+    if (a && b && c) {
+        // First-touch oleh thread yang sama dengan pengukuran
+        #pragma omp parallel for schedule(static) num_threads(threads)
+        for (size_t k = 0; k < n; k++) {
+            a[k] = 0.0;
+            b[k] = 1.0;
+            c[k] = 2.0;
+        }
+        for (int trial = 0; trial < STREAM_TRIALS; trial++) {
+            double t0 = omp_get_wtime();
+            #pragma omp parallel for schedule(static) num_threads(threads)
+            for (size_t k = 0; k < n; k++) a[k] = b[k] + 3.0 * c[k];
+            double t = omp_get_wtime() - t0;
+            double bw = 3.0 * n * sizeof(double) / t;
+            if (bw > best) best = bw;
+        }
     }
-    return img;
+    free(a);
+    free(b);
+    free(c);
+    if (threads >= 1 && threads <= PERF_MAX_THREADS) cached[threads] = best;
+    return best;
 }
 
 /*
- * Fungsi untuk membebaskan memori gambar
+ * Ukur satu run (threads == 0 -> versi serial) dengan counter, lalu cetak
+ * laporan roofline dan klasifikasi batasnya. Mengembalikan waktu run.
  */
-void free_image_2d(unsigned char** img, int height) {
-    for (int i = 0; i < height; i++)
-        free(img[i]);
-    free(img);
+double perf_report_run(const ImageView* src, int new_h, int new_w, int threads,
+                       KernelMode mode, double time_serial)
+{
+    int team = threads == 0 ? 1 : (threads > PERF_MAX_THREADS ? PERF_MAX_THREADS : threads);
+    double peak = stream_triad_peak(team);
+
+    ImageView out;
+    ResizeCoeffs co;
+    if (image_view_alloc(&out, new_w, new_h, src->channels, src->bit_depth) != 0) return 0.0;
+    if (resize_coeffs_build(&co, src->width, src->height, new_w, new_h,
+                            src->channels, src->bit_depth) != 0) {
+        image_view_free(&out);
+        return 0.0;
+    }
+    resize_row_fn row_kernel = select_row_kernel(mode, src->channels, src->bit_depth);
+    int band_h = plan_band_height(src->width, src->height, new_w, new_h,
+                                  (int)pixel_bytes(src->channels, src->bit_depth), team);
+    int n_bands = (new_h + band_h - 1) / band_h;
+
+    // Band loop sama dengan bilinear_resize_parallel_into, tapi di region yang juga
+    // membuka counter (serial = tim 1 thread, yaitu thread pemanggil)
+    PerfCounts pc = { 0, 0, 0, 1 };
+    double t0 = 0.0, t = 0.0;
+    #pragma omp parallel num_threads(team)
+    {
+        PerfThreadFds fds;
+        perf_start(&fds);
+        #pragma omp barrier
+        #pragma omp master
+        t0 = omp_get_wtime();
+        #pragma omp for schedule(static)
+        for (int b = 0; b < n_bands; b++) {
+            int i_end = (b + 1) * band_h < new_h ? (b + 1) * band_h : new_h;
+            for (int i = b * band_h; i < i_end; i++) {
+                row_kernel(view_row(src, co.y0[i]), view_row(src, co.y1[i]),
+                           view_row(&out, i), &co, i);
+            }
+        }
+        #pragma omp master
+        t = omp_get_wtime() - t0;
+        #pragma omp critical
+        perf_stop(&fds, &pc);
+    }
+    resize_coeffs_free(&co);
+    image_view_free(&out);
+
+    double pixels = (double)new_w * new_h;
+    size_t px = pixel_bytes(src->channels, src->bit_depth);
+    double moved = bench_bytes_moved(src, new_h, new_w);
+    double bytes_written = pixels * px;
+    double bytes_read = moved - bytes_written;
+    // Trafik DRAM terukur (LLC miss x cache line) jika counter tersedia, selain itu model
+    double dram = pc.valid ? (double)pc.llc_misses * CACHE_LINE_BYTES : moved;
+    double bw = dram / t;
+    double bw_frac = peak > 0.0 ? bw / peak : 0.0;
+
+    printf("%s:\n", threads == 0 ? "SERIAL" : "PARALEL");
+    if (threads > 0) printf("  Threads: %d\n", team);
+    printf("  Waktu: %.4f detik\n", t);
+    printf("  Byte per piksel output: baca %.2f, tulis %.2f (model)\n",
+           bytes_read / pixels, bytes_written / pixels);
+    if (pc.valid) {
+        printf("  Cycles: %.3e, instructions: %.3e, IPC: %.2f\n",
+               (double)pc.cycles, (double)pc.instructions,
+               pc.cycles ? (double)pc.instructions / pc.cycles : 0.0);
+        printf("  LLC miss: %.3e (%.2f MB, %.2f byte/piksel)\n",
+               (double)pc.llc_misses, dram / 1e6, dram / pixels);
+        printf("  Instruksi per byte DRAM: %.2f\n", dram > 0 ? pc.instructions / dram : 0.0);
+    } else {
+        printf("  Counter hardware: tidak tersedia (perf_event_open ditolak / bukan Linux)\n");
+    }
+    printf("  Bandwidth%s: %.2f GB/s dari puncak STREAM %.2f GB/s (%.0f%%)\n",
+           pc.valid ? "" : " (model)", bw / 1e9, peak / 1e9, bw_frac * 100.0);
+
+    // Klasifikasi batas: bandwidth -> overhead paralel -> compute; tanpa counter
+    // tidak ada trafik DRAM terukur untuk diklasifikasikan
+    const char* limit;
+    double efficiency = threads > 0 && time_serial > 0 ? time_serial / t / team : 1.0;
+    if (!pc.valid) {
+        limit = "tidak diketahui (counter tidak tersedia)";
+    } else if (bw_frac >= 0.6) {
+        limit = "BANDWIDTH MEMORI";
+    } else if (threads > 1 && efficiency < 0.5) {
+        limit = "OVERHEAD / SCHEDULING (bandwidth & compute belum jenuh)";
+    } else {
+        limit = "COMPUTE (bandwidth belum jenuh)";
+    }
+    if (threads > 0) printf("  Efisiensi paralel: %.2f%%\n", efficiency * 100.0);
+    printf("  Batas: %s\n\n", limit);
+    return t;
 }
 
-void free_image_struct(Image* img) {
-    if (img) {
-        if (img->data) free(img->data);
-        free(img);
+/*
+ * ==================== CPU Budget (--threads / --cpus) ====================
+ * Server membagi core antar job: --threads=N menjadi omp_get_max_threads() untuk
+ * semua mode, dan run demo 2/4/8 thread dibatasi sampai N. --cpus=LIST ("0-3,6")
+ * mengikat thread utama dan tim OpenMP ke core tsb (Linux). Setiap invocation
+ * (termasuk request mode worker) mulai dari setelan default proses.
+ */
+#define CPU_LIST_MAX 128
+
+static int cpu_default_threads = 0;
+#if defined(__linux__)
+static cpu_set_t cpu_default_mask;
+static int cpu_default_saved = 0;
+static int cpu_allowed[CPU_SETSIZE]; /* CPU di mask default, urut naik */
+static int cpu_allowed_count = 0;
+
+/*
+ * Parse "0-3,6,8-9"; return jumlah core atau -1 jika tidak valid.
+ * Angka = indeks ke CPU yang diizinkan untuk proses (modulo jumlahnya).
+ */
+static int cpu_parse_list(const char* spec, cpu_set_t* set)
+{
+    CPU_ZERO(set);
+    const char* p = spec;
+    while (*p) {
+        char* end;
+        long lo = strtol(p, &end, 10), hi = lo;
+        if (end == p || lo < 0) return -1;
+        p = end;
+        if (*p == '-') {
+            hi = strtol(p + 1, &end, 10);
+            if (end == p + 1 || hi < lo) return -1;
+            p = end;
+        }
+        if (hi >= CPU_SETSIZE) return -1;
+        for (long c = lo; c <= hi; c++) CPU_SET(cpu_allowed[c % cpu_allowed_count], set);
+        if (*p == ',') p++;
+        else if (*p) return -1;
     }
+    return CPU_COUNT(set);
 }
+#endif
 
 /*
- * Fungsi untuk memverifikasi hasil (membandingkan dua gambar RGB)
+ * Terapkan budget (threads 0 / cpus NULL = default proses).
+ * Return jumlah thread efektif, atau -1 jika --cpus tidak valid.
  */
-int verify_results(unsigned char** img1, unsigned char** img2, int h, int w) {
-    for (int i = 0; i < h; i++) {
-        for (int j = 0; j < w; j++) {
-            // Compare RGB values
-            if (img1[i][j * 3] != img2[i][j * 3] ||
-                img1[i][j * 3 + 1] != img2[i][j * 3 + 1] ||
-                img1[i][j * 3 + 2] != img2[i][j * 3 + 2]) {
-                return 0;
-            }
+static int cpu_budget_apply(int threads, const char* cpus)
+{
+    if (cpu_default_threads == 0) cpu_default_threads = omp_get_max_threads();
+#if defined(__linux__)
+    if (!cpu_default_saved) {
+        sched_getaffinity(0, sizeof(cpu_set_t), &cpu_default_mask);
+        for (int c = 0; c < CPU_SETSIZE; c++) {
+            if (CPU_ISSET(c, &cpu_default_mask)) cpu_allowed[cpu_allowed_count++] = c;
         }
+        cpu_default_saved = 1;
+    }
+    cpu_set_t set = cpu_default_mask;
+    if (cpus) {
+        if (strlen(cpus) >= CPU_LIST_MAX) return -1;
+        int count = cpu_parse_list(cpus, &set);
+        if (count <= 0) return -1;
+        if (threads == 0) threads = count;
+    }
+#else
+    (void)cpus;
+#endif
+    if (threads == 0) threads = cpu_default_threads;
+    omp_set_num_threads(threads);
+#if defined(__linux__)
+    sched_setaffinity(0, sizeof(cpu_set_t), &set);
+    /* Thread tim dipakai ulang libgomp antar region: pin sekali di sini */
+    #pragma omp parallel num_threads(threads)
+    {
+        sched_setaffinity(0, sizeof(cpu_set_t), &set);
     }
-    return 1;
+#endif
+    return threads;
 }
 
-int main(int argc, char* argv[])
+int bilinear_main(int argc, char* argv[])
 {
+    // Default filename, scaling dan kernel
+    const char* input_file = "gantrycrane.png";
+    double scale = 2.0;
+    KernelMode kernel = KERNEL_DOUBLE;
+    int png_level = PNG_DEFAULT_LEVEL;
+    const char* stream_out = NULL;
+    PpmWriteMode ppm_writer = PPM_WRITE_WRITEV;
+    int overlap = 0;
+    const char* batch_manifest = NULL;
+    const char* pyramid_scales = NULL;
+    const char* pyramid_prefix = "pyramid";
+    const char* out_prefix = "result"; // --out: PREFIX_serial.ppm/png, PREFIX_parallel_<T>.ppm/png
+    int threads = 0;                   // --threads=N; 0 = default proses
+    const char* cpus = NULL;           // --cpus=LIST
+    int emit = -1;                     // --emit=png|pam: hasil progresif ke stdout
+    int bench = 0;
+    int bench_reps = BENCH_DEFAULT_REPS;
+    int bench_warmup = BENCH_DEFAULT_WARMUP;
+    const char* bench_scales = NULL;
+    int perf = 0;
+    IsaLevel max_isa = detect_isa();
+    simd_isa = max_isa;
+    
+    // Argumen: file [scale] [--kernel=double|fixed|simd] [--isa=scalar|sse4.1|avx2|avx512]
+    //          [--png-level=0..9] [--stream[=output.ppm]]
+    //          [--ppm-writer=writev|mmap] [--overlap] [--batch=manifest.txt]
+    //          [--pyramid=0.25,0.5,2] [--pyramid-out=prefix]
+    //          [--bench] [--bench-reps=N] [--bench-warmup=N] [--bench-scales=0.5,1,2]
+    //          [--perf] [--out=prefix] [--threads=N] [--cpus=0-3] [--emit=png|pam]
+    int positional = 0;
+    for (int a = 1; a < argc; a++) {
+        if (strncmp(argv[a], "--kernel=", 9) == 0) {
+            const char* name = argv[a] + 9;
+            if (strcmp(name, "fixed") == 0) {
+                kernel = KERNEL_FIXED;
+            } else if (strcmp(name, "simd") == 0) {
+                kernel = KERNEL_SIMD;
+            } else if (strcmp(name, "double") != 0) {
+                printf("⚠️  Kernel '%s' tidak dikenal, memakai double\n", name);
+            }
+        } else if (strncmp(argv[a], "--isa=", 6) == 0) {
+            // Paksa ISA tertentu (dibatasi oleh kemampuan CPU)
+            const char* name = argv[a] + 6;
+            int found = -1;
+            for (int l = 0; l < ISA_COUNT; l++) {
+                if (strcmp(name, isa_name((IsaLevel)l)) == 0) found = l;
+            }
+            if (found >= 0 && found <= (int)max_isa) {
+                simd_isa = (IsaLevel)found;
+            } else {
+                printf("⚠️  ISA '%s' %s, memakai %s (pilihan:", name,
+                       found < 0 ? "tidak dikenal" : "tidak didukung CPU ini", isa_name(simd_isa));
+                for (int l = 0; l < ISA_COUNT; l++) printf(" %s", isa_name((IsaLevel)l));
+                printf("; maks CPU ini: %s)\n", isa_name(max_isa));
+            }
+        } else if (strcmp(argv[a], "--stream") == 0) {
+            stream_out = "result_stream.ppm";
+        } else if (strncmp(argv[a], "--stream=", 9) == 0) {
+            stream_out = argv[a] + 9;
+        } else if (strcmp(argv[a], "--ppm-writer=mmap") == 0) {
+            ppm_writer = PPM_WRITE_MMAP;
+        } else if (strcmp(argv[a], "--ppm-writer=writev") == 0) {
+            ppm_writer = PPM_WRITE_WRITEV;
+        } else if (strncmp(argv[a], "--pyramid=", 10) == 0) {
+            pyramid_scales = argv[a] + 10;
+        } else if (strncmp(argv[a], "--pyramid-out=", 14) == 0) {
+            pyramid_prefix = argv[a] + 14;
+        } else if (strncmp(argv[a], "--threads=", 10) == 0) {
+            threads = atoi(argv[a] + 10);
+            if (threads < 1 || threads > 256) {
+                printf("❌ --threads harus 1..256\n");
+                return 1;
+            }
+        } else if (strncmp(argv[a], "--cpus=", 7) == 0) {
+            cpus = argv[a] + 7;
+        } else if (strcmp(argv[a], "--emit=png") == 0) {
+            emit = EMIT_PNG;
+        } else if (strcmp(argv[a], "--emit=pam") == 0) {
+            emit = EMIT_PAM;
+        } else if (strncmp(argv[a], "--out=", 6) == 0 && argv[a][6]) {
+            out_prefix = argv[a] + 6;
+        } else if (strcmp(argv[a], "--perf") == 0) {
+            perf = 1;
+        } else if (strcmp(argv[a], "--bench") == 0) {
+            bench = 1;
+        } else if (strncmp(argv[a], "--bench-reps=", 13) == 0) {
+            bench_reps = atoi(argv[a] + 13);
+            if (bench_reps < 1) bench_reps = 1;
+        } else if (strncmp(argv[a], "--bench-warmup=", 15) == 0) {
+            bench_warmup = atoi(argv[a] + 15);
+            if (bench_warmup < 0) bench_warmup = 0;
+        } else if (strncmp(argv[a], "--bench-scales=", 15) == 0) {
+            bench_scales = argv[a] + 15;
+        } else if (strncmp(argv[a], "--batch=", 8) == 0) {
+            batch_manifest = argv[a] + 8;
+        } else if (strcmp(argv[a], "--overlap") == 0) {
+            overlap = 1;
+        } else if (strncmp(argv[a], "--png-level=", 12) == 0) {
+            png_level = atoi(argv[a] + 12);
+        } else if (positional == 0) {
+            input_file = argv[a];
+            positional++;
+        } else if (positional == 1) {
+            double tmp = atof(argv[a]);
+            if (tmp > 0.1 && tmp <= 10.0) {
+                scale = tmp;
+            }
+            positional++;
+        }
+    }
+
+    int budget = cpu_budget_apply(threads, cpus);
+    if (budget < 0) {
+        printf("❌ --cpus tidak valid (contoh: 0-3,6)\n");
+        return 1;
+    }
+    if (cpus) threads = budget; // --cpus tanpa --threads: satu thread per core
+
+    // ==================== MODE EMIT (progresif ke stdout) ====================
+    // stdout berisi citra biner; pesan error ke stderr
+    if (emit >= 0) {
+        if (fileno(stdout) < 0) {
+            printf("❌ --emit tidak tersedia di mode worker (stdout = kanal JSON)\n");
+            return 1;
+        }
+        const char* kind;
+        Image* img = load_image_file(input_file, &kind);
+        if (!img) {
+            fprintf(stderr, "bilinear: cannot read image '%s'\n", input_file);
+            return 1;
+        }
+        // Penerima menutup koneksi: write() gagal dengan EPIPE, bukan proses mati
+        signal(SIGPIPE, SIG_IGN);
+        ImageView view = image_view_of(img);
+        StreamStats st;
+        int ret = emit_resize(&view, STDOUT_FILENO, (EmitFormat)emit, scale, kernel,
+                              omp_get_max_threads(), png_level, &st);
+        free_image_struct(img);
+        if (ret != 0) {
+            fprintf(stderr, "bilinear: emit failed after %zu bytes\n", st.bytes_written);
+            return 1;
+        }
+        return 0;
+    }
+
+    // ==================== MODE BENCHMARK (JSON) ====================
+    if (bench) {
+        double scales[BENCH_MAX_SCALES] = { 0.5, 1.0, 2.0 };
+        int n_scales = 3;
+        if (bench_scales) {
+            n_scales = parse_scale_list(bench_scales, scales, BENCH_MAX_SCALES);
+        } else if (positional > 1) {
+            scales[0] = scale; // skala dari argumen posisi
+            n_scales = 1;
+        }
+        const char* kind;
+        Image* img = load_image_file(input_file, &kind);
+        if (!img || n_scales == 0) {
+            printf("{ \"benchmark\": \"bilinear\", \"status\": \"error\", "
+                   "\"error\": \"%s\" }\n",
+                   img ? "invalid scale list" : "cannot read image");
+            image_discard(img);
+            return 1;
+        }
+        ImageView view = image_view_of(img);
+        int ret = run_benchmark(input_file, &view, scales, n_scales, kernel, bench_warmup, bench_reps);
+        free_image_struct(img);
+        return ret == 0 ? 0 : 1;
+    }
+
     printf("=================================================================\n");
     printf("  INTERPOLASI BILINEAR: SERIAL vs PARALEL (OpenMP)\n");
     printf("  Input: Real PNG Image (RGB COLOR)\n");
     printf("=================================================================\n\n");
 
-    // Default filename dan scaling
-    const char* input_file = "gantrycrane.png";
-    double scale = 2.0;
-    
-    // Argumen: file [scale]
-    if (argc > 1) {
-        input_file = argv[1];
+    // ==================== MODE BATCH ====================
+    if (batch_manifest) {
+        BatchJob* jobs = NULL;
+        int n = load_batch_manifest(batch_manifest, &jobs);
+        if (n < 0) {
+            printf("❌ Error: Manifest '%s' tidak dapat dibaca\n", batch_manifest);
+            return 1;
+        }
+        printf("--- BATCH RESIZE: %d gambar (kernel %s) ---\n", n, kernel_mode_name(kernel));
+        int ok = run_batch(jobs, n, kernel, omp_get_max_threads(), png_level);
+        free(jobs);
+        return ok == n ? 0 : 1;
     }
-    if (argc > 2) {
-        double tmp = atof(argv[2]);
-        if (tmp > 0.1 && tmp <= 10.0) {
-            scale = tmp;
+
+    // ==================== MODE STREAMING ====================
+    if (stream_out) {
+        int num_threads = omp_get_max_threads();
+        StreamStats st;
+        printf("--- STREAMING RESIZE (out-of-core) ---\n");
+        printf("Kernel: %s, %d threads%s\n", kernel_mode_name(kernel), num_threads,
+               overlap ? ", tulis overlap" : "");
+        double t0 = omp_get_wtime();
+        if (stream_resize_pnm(input_file, stream_out, scale, kernel, num_threads, overlap, &st) != 0) {
+            return 1;
         }
+        double t = omp_get_wtime() - t0;
+        const char* format = image_format_name(st.channels, st.bit_depth);
+        printf("Ukuran gambar sumber: %dx%d (%s)\n", st.src_h, st.src_w, format);
+        printf("Ukuran gambar hasil: %dx%d (%s)\n", st.new_h, st.new_w, format);
+        printf("Band: %d baris\n", st.band_h);
+        printf("Memori puncak buffer: %.2f MB (citra penuh: %.2f MB)\n",
+               st.peak_bytes / 1e6, ((double)st.src_w * st.src_h + (double)st.new_w * st.new_h) *
+                   pixel_bytes(st.channels, st.bit_depth) / 1e6);
+        printf("Dibaca: %.2f MB, ditulis: %.2f MB\n", st.bytes_read / 1e6, st.bytes_written / 1e6);
+        printf("Waktu eksekusi STREAMING: %.4f detik\n", t);
+        printf("✅ Hasil disimpan ke: %s\n", stream_out);
+        return 0;
     }
 
-    // Baca PNG image
-    Image* src_img = read_png_as_rgb(input_file);
+    // Baca gambar (PNG / PPM / PAM) langsung ke buffer input
+    Image* src_img = read_image(input_file);
     if (!src_img) {
         printf("\n❌ Gagal membaca gambar. Pastikan:\n");
         printf("   1. File '%s' ada di directory saat ini\n", input_file);
-        printf("   2. File format PNG valid\n");
-        printf("   3. ImageMagick terinstall: brew install imagemagick\n");
+        printf("   2. Format file PNG, PPM (P5/P6) atau PAM (P7) yang valid\n");
         return 1;
     }
 
@@ -311,70 +3592,232 @@ int main(int argc, char* argv[])
     int src_w = src_img->width;
     
     // Scaling parameters (gunakan faktor dinamis)
-    int new_h = (int)(src_h * scale + 0.5);
-    int new_w = (int)(src_w * scale + 0.5);
-    if (new_h < 1) new_h = 1;
-    if (new_w < 1) new_w = 1;
+    int new_h, new_w;
+    resize_target_dims(src_w, src_h, scale, &new_w, &new_h);
+
+    const char* format = image_format_name(src_img->channels, src_img->bit_depth);
+    printf("Ukuran gambar sumber: %dx%d (%s)\n", src_h, src_w, format);
+    printf("Ukuran gambar hasil: %dx%d (%s)\n", new_h, new_w, format);
+    printf("Faktor scaling: %.2fx\n", scale);
+    if (kernel == KERNEL_SIMD) {
+        printf("Kernel: %s (%s, CPU mendukung s/d %s)\n\n",
+               kernel_mode_name(kernel), isa_name(simd_isa), isa_name(max_isa));
+    } else {
+        printf("Kernel: %s\n\n", kernel_mode_name(kernel));
+    }
+    if (kernel == KERNEL_SIMD && src_img->bit_depth == 16) {
+        printf("ℹ️  Citra 16-bit: kernel simd memakai fixed-point Q16 scalar\n\n");
+    }
+
+    // View langsung di atas Image.data (tanpa salinan)
+    ImageView src = image_view_of(src_img);
+
+    // ==================== MODE PYRAMID ====================
+    if (pyramid_scales) {
+        PyramidLevel levels[PYRAMID_MAX_LEVELS];
+        double scales[PYRAMID_MAX_LEVELS];
+        int n_levels = parse_scale_list(pyramid_scales, scales, PYRAMID_MAX_LEVELS);
+        memset(levels, 0, sizeof(levels));
+        for (int l = 0; l < n_levels; l++) levels[l].scale = scales[l];
+        int num_threads = omp_get_max_threads();
+        if (n_levels == 0) {
+            printf("❌ Error: Daftar skala '%s' tidak valid\n", pyramid_scales);
+            free_image_struct(src_img);
+            return 1;
+        }
+        printf("--- PYRAMID: %d level, satu pass (%d threads) ---\n", n_levels, num_threads);
+        double t0 = omp_get_wtime();
+        if (build_pyramid(&src, levels, n_levels, num_threads, kernel) != 0) {
+            printf("❌ Error: Gagal mengalokasikan pyramid\n");
+            free_image_struct(src_img);
+            return 1;
+        }
+        double time_pyramid = omp_get_wtime() - t0;
 
-    printf("Ukuran gambar sumber: %dx%d (RGB)\n", src_h, src_w);
-    printf("Ukuran gambar hasil: %dx%d (RGB)\n", new_h, new_w);
-    printf("Faktor scaling: %.2fx\n\n", scale);
+        // Pembanding: satu resize terpisah per skala (sumber dibaca N kali)
+        double time_separate = 0.0;
+        int all_match = 1;
+        for (int l = 0; l < n_levels; l++) {
+            PyramidLevel* L = &levels[l];
+            t0 = omp_get_wtime();
+            ImageView ref = bilinear_resize_parallel(&src, L->out.height, L->out.width,
+                                                     num_threads, kernel);
+            time_separate += omp_get_wtime() - t0;
+            int match = ref.data && verify_results(&ref, &L->out);
+            all_match &= match;
+            printf("  %.2fx -> %dx%d: %s\n", L->scale, L->out.height, L->out.width,
+                   match ? "identik" : "BERBEDA");
+            image_view_free(&ref);
+        }
+        printf("Waktu eksekusi PYRAMID (satu pass): %.4f detik\n", time_pyramid);
+        printf("Waktu %d resize terpisah: %.4f detik\n", n_levels, time_separate);
+        printf("Sumber dibaca: 1x (vs %dx untuk resize terpisah)\n", n_levels);
 
-    // Convert to 2D array untuk processing
-    unsigned char** src = image_to_2d(src_img->data, src_h, src_w);
+        for (int l = 0; l < n_levels; l++) {
+            char name[600];
+            snprintf(name, sizeof(name), "%s_%gx.ppm", pyramid_prefix, levels[l].scale);
+            write_ppm_with(name, &levels[l].out, ppm_writer);
+        }
+        pyramid_levels_free(levels, n_levels);
+        free_image_struct(src_img);
+        return all_match ? 0 : 1;
+    }
 
     // ==================== EKSEKUSI SERIAL ====================
     printf("--- EKSEKUSI SERIAL ---\n");
     double time_start_serial = omp_get_wtime();
     
-    unsigned char** result_serial = bilinear_resize_serial(src, src_h, src_w, new_h, new_w);
+    ImageView result_serial = bilinear_resize_serial(&src, new_h, new_w, kernel);
     
     double time_end_serial = omp_get_wtime();
     double time_serial = time_end_serial - time_start_serial;
     
+    if (!result_serial.data) {
+        printf("❌ Error: Gagal alokasi memori hasil\n");
+        free_image_struct(src_img);
+        return 1;
+    }
+
     printf("Waktu eksekusi SERIAL: %.4f detik\n", time_serial);
 
-    // Save serial result
-    write_ppm("result_serial.ppm", result_serial, new_h, new_w);
+    // Cek toleransi kernel fixed-point terhadap referensi double
+    if (kernel != KERNEL_DOUBLE) {
+        ImageView reference = bilinear_resize_serial(&src, new_h, new_w, KERNEL_DOUBLE);
+        ImageQuality q;
+        if (reference.data) {
+            double t0 = omp_get_wtime();
+            int valid = image_quality(&reference, &result_serial, &q) == 0;
+            double time_quality = omp_get_wtime() - t0;
+            if (valid) {
+                printf("Toleransi vs double: max |selisih| = %d (batas %d), PSNR = %.2f dB %s\n",
+                       q.max_abs_err, FIXED_TOLERANCE, q.psnr,
+                       q.max_abs_err <= FIXED_TOLERANCE ? "✓" : "✗");
+                printf("Waktu cek toleransi: %.4f detik\n", time_quality);
+            }
+            image_view_free(&reference);
+        }
+    }
+
+    // Kernel SIMD harus bit-identik dengan fixed-point scalar di setiap level ISA
+    if (kernel == KERNEL_SIMD) {
+        ImageView scalar_ref = bilinear_resize_serial(&src, new_h, new_w, KERNEL_FIXED);
+        ImageDigest scalar_digest = { 0 };
+        int have_ref = scalar_ref.data && image_digest(&scalar_ref, &scalar_digest) == 0;
+        IsaLevel chosen = simd_isa;
+        for (int l = ISA_SSE41; l <= (int)max_isa && have_ref; l++) {
+            simd_isa = (IsaLevel)l;
+            // Format tanpa kernel SIMD (mis. 16-bit) memakai kernel scalar: tidak ada yang dibandingkan
+            if (select_row_kernel(KERNEL_SIMD, src.channels, src.bit_depth) ==
+                select_row_kernel(KERNEL_FIXED, src.channels, src.bit_depth)) {
+                printf("Verifikasi ISA %-7s vs scalar: dilewati (fallback skalar untuk %s)\n",
+                       isa_name(simd_isa), image_format_name(src.channels, src.bit_depth));
+                continue;
+            }
+            ImageView out = bilinear_resize_serial(&src, new_h, new_w, KERNEL_SIMD);
+            int same = out.data && verify_against_digest(&scalar_digest, &out);
+            printf("Verifikasi ISA %-7s vs scalar: %s\n", isa_name(simd_isa),
+                   same ? "bit-identik ✓" : "BERBEDA ✗");
+            image_view_free(&out);
+        }
+        simd_isa = chosen;
+        image_digest_free(&scalar_digest);
+        image_view_free(&scalar_ref);
+    }
+
+    // Run paralel demo: 2, 4, 8 thread; dengan --threads=N hanya yang < N, lalu N
+    int thread_counts[4];
+    int num_tests = 0;
+    int demo_counts[] = {2, 4, 8};
+    for (int t = 0; t < 3; t++) {
+        if (!threads || demo_counts[t] < threads) thread_counts[num_tests++] = demo_counts[t];
+    }
+    if (threads > 1) thread_counts[num_tests++] = threads;
+    int max_test_threads = num_tests ? thread_counts[num_tests - 1] : 0;
+
+    // Nama file hasil dari --out (server memakai prefix unik per job agar request
+    // yang berjalan bersamaan tidak saling menimpa)
+    char serial_ppm[PATH_MAX], serial_png[PATH_MAX], parallel_ppm[PATH_MAX], parallel_png[PATH_MAX];
+    snprintf(serial_ppm, sizeof(serial_ppm), "%s_serial.ppm", out_prefix);
+    snprintf(serial_png, sizeof(serial_png), "%s_serial.png", out_prefix);
+    snprintf(parallel_ppm, sizeof(parallel_ppm), "%s_parallel_%d.ppm", out_prefix, max_test_threads);
+    snprintf(parallel_png, sizeof(parallel_png), "%s_parallel_%d.png", out_prefix, max_test_threads);
+
+    // Save serial result (waktu tulis dilaporkan terpisah dari waktu resize)
+    const char* writer_name = ppm_writer == PPM_WRITE_MMAP ? "mmap" : "writev";
+    double time_write_start = omp_get_wtime();
+    write_ppm_with(serial_ppm, &result_serial, ppm_writer);
+    double time_write = omp_get_wtime() - time_write_start;
+    printf("Waktu tulis output (PPM, %s): %.4f detik\n", writer_name, time_write);
 
     // ==================== EKSEKUSI PARALEL ====================
-    int thread_counts[] = {2, 4, 8};
-    int num_tests = 3;
-    unsigned char** result_parallel_8 = NULL;
+    ImageView result_parallel_8 = { 0 }; // hasil run dengan thread terbanyak
 
     printf("\n--- EKSEKUSI PARALEL (OpenMP) ---\n");
-    printf("Jumlah core tersedia: %d\n\n", omp_get_max_threads());
+    printf("Jumlah core tersedia: %d\n", omp_get_max_threads());
+
+    // Digest hasil serial dihitung sekali, dipakai untuk verifikasi semua run paralel
+    ImageDigest serial_digest = { 0 };
+    double time_digest_start = omp_get_wtime();
+    int have_digest = image_digest(&result_serial, &serial_digest) == 0;
+    printf("Digest referensi: %d band, %.4f detik\n\n", serial_digest.n_bands,
+           omp_get_wtime() - time_digest_start);
 
     for (int t = 0; t < num_tests; t++) {
         int num_threads = thread_counts[t];
         
+        int band_h = plan_band_height(src_w, src_h, new_w, new_h,
+                                      (int)pixel_bytes(src.channels, src.bit_depth), num_threads);
         printf("Testing dengan %d threads:\n", num_threads);
+        printf("  Band: %d baris x %d band (L2 = %zu KB)\n", band_h,
+               (new_h + band_h - 1) / band_h, l2_cache_bytes() / 1024);
+        // --overlap: run thread terbanyak langsung menulis PPM-nya (band N ditulis
+        // sementara band N+1 dihitung), jadi waktunya = resize + tulis
+        int write_overlap = overlap && num_threads == max_test_threads;
         double time_start_parallel = omp_get_wtime();
         
-        unsigned char** result_parallel = bilinear_resize_parallel(
-            src, src_h, src_w, new_h, new_w, num_threads);
+        ImageView result_parallel = write_overlap
+            ? bilinear_resize_parallel_to_ppm(&src, new_h, new_w, num_threads, kernel, parallel_ppm)
+            : bilinear_resize_parallel(&src, new_h, new_w, num_threads, kernel);
         
         double time_end_parallel = omp_get_wtime();
         double time_parallel = time_end_parallel - time_start_parallel;
         
-        printf("  Waktu eksekusi: %.4f detik\n", time_parallel);
+        if (write_overlap) {
+            printf("  Waktu resize + tulis (overlap): %.4f detik (serial berurutan: %.4f + %.4f)\n",
+                   time_parallel, time_serial, time_write);
+        } else {
+            printf("  Waktu eksekusi: %.4f detik\n", time_parallel);
+        }
         
-        // Hitung speedup
-        double speedup = time_serial / time_parallel;
+        // Hitung speedup (run overlap dibandingkan dengan resize + tulis serial)
+        double speedup = (time_serial + (write_overlap ? time_write : 0.0)) / time_parallel;
         double efficiency = (speedup / num_threads) * 100.0;
         
         printf("  Speedup: %.2fx\n", speedup);
         printf("  Efficiency: %.2f%%\n", efficiency);
         
-        // Verifikasi hasil
-        int is_correct = verify_results(result_serial, result_parallel, new_h, new_w);
-        printf("  Verifikasi: %s\n\n", is_correct ? "BENAR ✓" : "SALAH ✗");
+        // Verifikasi hasil (hash paralel, waktunya terpisah dari waktu kernel)
+        double time_verify_start = omp_get_wtime();
+        int is_correct = result_parallel.data && have_digest &&
+                         verify_against_digest(&serial_digest, &result_parallel);
+        double time_verify = omp_get_wtime() - time_verify_start;
+        printf("  Verifikasi: %s\n", is_correct ? "BENAR ✓" : "SALAH ✗");
+        printf("  Waktu verifikasi: %.4f detik\n\n", time_verify);
         
-        // Simpan result parallel 8-thread
-        if (num_threads == 8) {
+        // Simpan result parallel thread terbanyak (8 tanpa --threads)
+        if (num_threads == max_test_threads) {
             result_parallel_8 = result_parallel;
         } else {
-            free_image_2d(result_parallel, new_h);
+            image_view_free(&result_parallel);
+        }
+    }
+
+    // ==================== PERFORMANCE COUNTER / ROOFLINE ====================
+    if (perf) {
+        printf("\n--- PERFORMANCE COUNTER & ROOFLINE ---\n");
+        perf_report_run(&src, new_h, new_w, 0, kernel, time_serial);
+        for (int t = 0; t < num_tests; t++) {
+            perf_report_run(&src, new_h, new_w, thread_counts[t], kernel, time_serial);
         }
     }
 
@@ -382,53 +3825,241 @@ int main(int argc, char* argv[])
     printf("\n=================================================================\n");
     printf("  RINGKASAN PERFORMA\n");
     printf("=================================================================\n");
-    printf("Algoritma ini adalah MEMORY BOUND, bukan COMPUTE BOUND\n");
-    printf("Speedup terbatas oleh bandwidth memori, bukan jumlah core CPU.\n");
+    if (perf) {
+        printf("Batas performa per run terukur di bagian PERFORMANCE COUNTER di atas.\n");
+    } else {
+        printf("Dugaan: algoritma ini MEMORY BOUND, bukan COMPUTE BOUND\n");
+        printf("Jalankan dengan --perf untuk mengukur (counter hardware + puncak STREAM).\n");
+    }
     printf("\nHasil disimpan:\n");
-    printf("  - result_serial.ppm (hasil dari versi SERIAL)\n");
-    printf("  - result_parallel_8.ppm (hasil dari versi PARALLEL 8-thread)\n");
+    printf("  - %s (hasil dari versi SERIAL)\n", serial_ppm);
+    if (result_parallel_8.data) {
+        printf("  - %s (hasil dari versi PARALLEL %d-thread)\n", parallel_ppm, max_test_threads);
+    }
     printf("=================================================================\n");
 
     // ==================== SAVE PARALLEL RESULT ====================
-    if (result_parallel_8) {
-        write_ppm("result_parallel_8.ppm", result_parallel_8, new_h, new_w);
+    // Dengan --overlap PPM paralel sudah ditulis di dalam run-nya sendiri
+    if (!overlap && result_parallel_8.data) {
+        double t0 = omp_get_wtime();
+        write_ppm_with(parallel_ppm, &result_parallel_8, ppm_writer);
+        printf("Waktu tulis output (PPM, %s): %.4f detik\n", writer_name, omp_get_wtime() - t0);
     }
 
-    // ==================== CONVERT PPM TO PNG ====================
-    printf("\n🔄 Converting PPM to PNG...\n");
-    
-    // Convert serial result
-    char convert_cmd[256];
-    snprintf(convert_cmd, sizeof(convert_cmd),
-             "convert result_serial.ppm result_serial.png 2>/dev/null");
-    int convert_ret = system(convert_cmd);
-    
-    if (convert_ret == 0) {
-        printf("✅ PNG file created: result_serial.png\n");
+    // ==================== ENCODE PNG (in-process) ====================
+    printf("\n🔄 Encoding PNG (deflate level %d)...\n", png_level);
+
+    double time_png_start = omp_get_wtime();
+    if (write_png(serial_png, &result_serial, png_level) == 0) {
+        printf("✅ PNG file created: %s\n", serial_png);
     } else {
-        printf("⚠️  Warning: Could not convert serial result to PNG.\n");
+        printf("⚠️  Warning: Could not encode serial result to PNG.\n");
     }
 
-    // Convert parallel result
-    if (result_parallel_8) {
-        snprintf(convert_cmd, sizeof(convert_cmd),
-                 "convert result_parallel_8.ppm result_parallel_8.png 2>/dev/null");
-        convert_ret = system(convert_cmd);
-        
-        if (convert_ret == 0) {
-            printf("✅ PNG file created: result_parallel_8.png\n");
+    if (result_parallel_8.data) {
+        if (write_png(parallel_png, &result_parallel_8, png_level) == 0) {
+            printf("✅ PNG file created: %s\n", parallel_png);
         } else {
-            printf("⚠️  Warning: Could not convert parallel result to PNG.\n");
+            printf("⚠️  Warning: Could not encode parallel result to PNG.\n");
         }
     }
+    printf("Waktu encode PNG: %.4f detik\n", omp_get_wtime() - time_png_start);
 
     // Cleanup
-    free_image_2d(src, src_h);
-    free_image_2d(result_serial, new_h);
-    if (result_parallel_8) {
-        free_image_2d(result_parallel_8, new_h);
-    }
+    image_digest_free(&serial_digest);
+    image_view_free(&result_serial);
+    image_view_free(&result_parallel_8);
     free_image_struct(src_img);
 
     return 0;
 }
+
+/* Build library (-DBILINEAR_LIBRARY, addon Node di native/): tanpa worker mode dan main */
+#ifndef BILINEAR_LIBRARY
+
+/*
+ * ==================== Worker Mode (--worker) ====================
+ * Proses berumur panjang untuk server: satu request JSON per baris di stdin,
+ *   {"id": 7, "args": ["gantrycrane.png", "2.0"]}   atau   {"id": 8, "op": "ping"}
+ * Argumen dijalankan persis seperti invocation CLI (bilinear_main) dengan stdout
+ * ditangkap ke memori. Tim OpenMP dan buffer pool tetap hidup antar request;
+ * pool di-trim bila cache-nya melewati WORKER_POOL_CACHE_MAX.
+ * Satu baris respons per request: {"id": 7, "exit": 0, "output": "<teks stdout>"}
+ */
+#define WORKER_MAX_ARGS 32
+#define WORKER_ID_MAX 64
+#define WORKER_POOL_CACHE_MAX ((size_t)256 << 20)
+
+static const char* json_skip_ws(const char* p)
+{
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+    return p;
+}
+
+/*
+ * String JSON di p (dimulai '"') ke out (escape dasar + \uXXXX ASCII);
+ * return posisi setelah '"' penutup atau NULL
+ */
+static const char* json_parse_string(const char* p, char* out, size_t cap)
+{
+    size_t len = 0;
+    if (*p++ != '"') return NULL;
+    while (*p && *p != '"') {
+        char c = *p++;
+        if (c == '\\') {
+            c = *p++;
+            switch (c) {
+            case 'n': c = '\n'; break;
+            case 't': c = '\t'; break;
+            case 'r': c = '\r'; break;
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'u': {
+                unsigned v;
+                if (sscanf(p, "%4x", &v) != 1 || v > 0x7F) return NULL;
+                c = (char)v;
+                p += 4;
+                break;
+            }
+            case '"': case '\\': case '/': break;
+            default: return NULL;
+            }
+        }
+        if (len + 1 >= cap) return NULL;
+        out[len++] = c;
+    }
+    if (*p != '"') return NULL;
+    out[len] = '\0';
+    return p + 1;
+}
+
+/*
+ * Parse request satu baris (objek datar: "id" angka/string, "op" string,
+ * "args" array string). String args disimpan berurutan di storage.
+ * Return argc atau -1
+ */
+static int worker_parse_request(const char* line, char* id, char* op, char* storage,
+                                size_t cap, char** args, int max_args)
+{
+    char key[32];
+    int argc = 0;
+    size_t used = 0;
+    const char* p = json_skip_ws(line);
+    strcpy(id, "null");
+    op[0] = '\0';
+    if (*p++ != '{') return -1;
+    for (;;) {
+        p = json_skip_ws(p);
+        if (*p == '}') break;
+        if (!(p = json_parse_string(p, key, sizeof(key)))) return -1;
+        p = json_skip_ws(p);
+        if (*p++ != ':') return -1;
+        p = json_skip_ws(p);
+        if (strcmp(key, "args") == 0) {
+            if (*p++ != '[') return -1;
+            p = json_skip_ws(p);
+            while (*p != ']') {
+                if (argc >= max_args) return -1;
+                args[argc] = storage + used;
+                if (!(p = json_parse_string(p, storage + used, cap - used))) return -1;
+                used += strlen(args[argc++]) + 1;
+                p = json_skip_ws(p);
+                if (*p == ',') p = json_skip_ws(p + 1);
+                else if (*p != ']') return -1;
+            }
+            p++;
+        } else if (*p == '"') {
+            char value[WORKER_ID_MAX];
+            const char* start = p;
+            if (!(p = json_parse_string(p, value, sizeof(value)))) return -1;
+            if (strcmp(key, "op") == 0) {
+                snprintf(op, WORKER_ID_MAX, "%s", value);
+            } else if (strcmp(key, "id") == 0) {
+                snprintf(id, WORKER_ID_MAX, "%.*s", (int)(p - start), start);
+            }
+        } else {
+            /* angka / true / false / null */
+            const char* start = p;
+            while (*p && *p != ',' && *p != '}' && *p != ' ') p++;
+            if (p == start || (size_t)(p - start) >= WORKER_ID_MAX) return -1;
+            if (strcmp(key, "id") == 0) snprintf(id, WORKER_ID_MAX, "%.*s", (int)(p - start), start);
+        }
+        p = json_skip_ws(p);
+        if (*p == ',') p++;
+        else if (*p != '}') return -1;
+    }
+    return argc;
+}
+
+/*
+ * Tulis teks sebagai string JSON (byte UTF-8 apa adanya, karakter kontrol di-escape)
+ */
+static void json_write_string(FILE* f, const char* text, size_t len)
+{
+    fputc('"', f);
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '"' || c == '\\') {
+            fputc('\\', f);
+            fputc(c, f);
+        } else if (c == '\n') {
+            fputs("\\n", f);
+        } else if (c < 0x20) {
+            fprintf(f, "\\u%04x", c);
+        } else {
+            fputc(c, f);
+        }
+    }
+    fputc('"', f);
+}
+
+int run_worker(void)
+{
+    char* line = NULL;
+    size_t line_cap = 0;
+    while (getline(&line, &line_cap, stdin) > 0) {
+        char id[WORKER_ID_MAX], op[WORKER_ID_MAX], storage[4096];
+        char* args[WORKER_MAX_ARGS + 1];
+        int argc = worker_parse_request(line, id, op, storage, sizeof(storage),
+                                        args + 1, WORKER_MAX_ARGS);
+        if (argc < 0) {
+            printf("{\"id\": %s, \"error\": \"invalid request\"}\n", id);
+        } else if (strcmp(op, "ping") == 0) {
+            printf("{\"id\": %s, \"pong\": true}\n", id);
+        } else {
+            /* stdout dialihkan ke memori selama bilinear_main berjalan */
+            char* text = NULL;
+            size_t len = 0;
+            FILE* mem = open_memstream(&text, &len);
+            int ret = 1;
+            if (mem) {
+                FILE* saved = stdout;
+                fflush(stdout);
+                stdout = mem;
+                args[0] = "bilinear";
+                ret = bilinear_main(argc + 1, args);
+                fflush(mem);
+                stdout = saved;
+                fclose(mem);
+            }
+            printf("{\"id\": %s, \"exit\": %d, \"output\": ", id, ret);
+            json_write_string(stdout, text ? text : "", len);
+            printf("}\n");
+            free(text);
+            pool_trim(WORKER_POOL_CACHE_MAX);
+        }
+        fflush(stdout);
+    }
+    free(line);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "--worker") == 0) {
+        return run_worker();
+    }
+    return bilinear_main(argc, argv);
+}
+
+#endif /* BILINEAR_LIBRARY */
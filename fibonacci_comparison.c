@@ -1,7 +1,11 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <time.h>
-#include <sys/time.h>
+
+// Varian rekursif memakai int 32-bit dan waktu eksponensial: hanya sampai batas ini
+#define RECURSIVE_MAX_N 45
 
 // ==================== Sequential Implementation ====================
 int fib_sequential(int n) {
@@ -13,13 +17,16 @@ int fib_sequential(int n) {
 #ifdef USE_OPENMP
 #include <omp.h>
 
-#define CUTOFF 20  // Threshold untuk menghindari overhead task creation
+#define CUTOFF 20  // Threshold untuk menghindari overhead task creation (default)
+
+// Bisa diganti lewat --cutoff=N (mis. hasil --autotune dari fib_omp_json)
+static int omp_cutoff = CUTOFF;
 
 int fib_omp_task(int n) {
     if (n < 2) return n;
     
     // Gunakan sequential untuk n kecil (menghindari overhead)
-    if (n < CUTOFF) {
+    if (n < omp_cutoff) {
         return fib_sequential(n);
     }
     
@@ -64,8 +71,17 @@ int fibonacci_openmp_serial(int n) {
 #ifdef USE_CILK
 #include <cilk/cilk.h>
 
+#define CILK_CUTOFF 20 // Tanpa cutoff, spawn turun sampai n = 2
+
+static int cilk_cutoff = CILK_CUTOFF;
+
 int fib_cilk_task(int n) {
     if (n < 2) return n;
+
+    // Gunakan sequential untuk n kecil (menghindari overhead spawn)
+    if (n < cilk_cutoff) {
+        return fib_sequential(n);
+    }
     
     int x, y;
     
@@ -97,33 +113,97 @@ int fib_cilk_serial(int n) {
 }
 #endif
 
-// Fungsi untuk mengukur waktu dengan presisi tinggi
-double get_wall_time() {
-    struct timeval time;
-    gettimeofday(&time, NULL);
-    return (double)time.tv_sec + (double)time.tv_usec * 0.000001;
+// ==================== Fast Doubling (O(log n)) ====================
+// F(2k)   = F(k) * (2*F(k+1) - F(k))
+// F(2k+1) = F(k)^2 + F(k+1)^2
+// Aritmetika unsigned wrap-around tetap benar modulo 2^64 / 2^128,
+// sehingga hasil eksak selama F(n) muat di tipe tersebut.
+#define FIB_U64_MAX_N 93   // F(93)  < 2^64
+#define FIB_U128_MAX_N 186 // F(186) < 2^128
+
+typedef unsigned __int128 uint128_t;
+
+uint64_t fib_fast_doubling_u64(uint64_t n) {
+    uint64_t a = 0, b = 1; // F(k), F(k+1)
+    for (int bit = 63; bit >= 0; bit--) {
+        uint64_t c = a * (2 * b - a);
+        uint64_t d = a * a + b * b;
+        if ((n >> bit) & 1) {
+            a = d;
+            b = c + d;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return a;
 }
 
-// ==================== Main Program ====================
-int main(int argc, char *argv[]) {
-    int N = 35; // Default value
-    
-    if (argc > 1) {
-        N = atoi(argv[1]);
+uint128_t fib_fast_doubling_u128(uint64_t n) {
+    uint128_t a = 0, b = 1;
+    for (int bit = 63; bit >= 0; bit--) {
+        uint128_t c = a * (2 * b - a);
+        uint128_t d = a * a + b * b;
+        if ((n >> bit) & 1) {
+            a = d;
+            b = c + d;
+        } else {
+            a = c;
+            b = d;
+        }
     }
-    
-    printf("==================================================================\n");
-    printf("        PERBANDINGAN FIBONACCI: SERIAL vs PARALLEL               \n");
-    printf("==================================================================\n");
-    printf("Menghitung Fibonacci ke-%d\n", N);
-    
+    return a;
+}
+
+// F(n) mod m untuk n berapa pun (m >= 1); perkalian lewat 128-bit agar tidak overflow
+uint64_t fib_fast_doubling_mod(uint64_t n, uint64_t m) {
+    uint64_t a = 0, b = 1 % m;
+    for (int bit = 63; bit >= 0; bit--) {
+        uint64_t t = (uint64_t)(((uint128_t)2 * b + m - a) % m);
+        uint64_t c = (uint64_t)((uint128_t)a * t % m);
+        uint64_t d = (uint64_t)(((uint128_t)a * a % m + (uint128_t)b * b % m) % m);
+        if ((n >> bit) & 1) {
+            a = d;
+            b = (uint64_t)(((uint128_t)c + d) % m);
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return a;
+}
+
+// Desimal uint128 (printf tidak punya format untuk __int128)
+void uint128_to_string(uint128_t v, char* buf) {
+    char tmp[40];
+    int len = 0;
+    do {
+        tmp[len++] = (char)('0' + (int)(v % 10));
+        v /= 10;
+    } while (v);
+    for (int i = 0; i < len; i++) buf[i] = tmp[len - 1 - i];
+    buf[len] = '\0';
+}
+
+// Fungsi untuk mengukur waktu dengan presisi tinggi: jam monotonic (raw bila ada),
+// tidak ikut dikoreksi NTP / perubahan jam sistem
+double get_wall_time() {
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC_RAW
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// ==================== Varian Rekursif (1-5) ====================
+// Return waktu baseline (pure sequential) untuk perbandingan fast doubling
+double run_recursive_variants(int N) {
 #ifdef USE_OPENMP
     int num_threads = omp_get_max_threads();
-    printf("Jumlah thread yang tersedia: %d\n", num_threads);
 #endif
-    
-    printf("==================================================================\n");
-    
+
     // WARM-UP RUN untuk mengatasi cache warming effect
     printf("\n[Warm-up] Menjalankan warm-up untuk stabilisasi performa...\n");
     volatile int warmup_result = fib_sequential(N);
@@ -182,7 +262,7 @@ int main(int argc, char *argv[]) {
     printf("   Waktu      : %.6f detik\n", time_taken);
     printf("   Speedup    : %.2fx\n", speedup_omp);
     printf("   Efficiency : %.2f%%\n", efficiency_omp);
-    printf("   Cutoff     : %d (task creation threshold)\n", CUTOFF);
+    printf("   Cutoff     : %d (task creation threshold)\n", omp_cutoff);
     printf("   Model      : Fork-Join dengan Task Dependency\n\n");
 #endif
 
@@ -219,10 +299,113 @@ int main(int argc, char *argv[]) {
     printf("   Hasil      : %d\n", result);
     printf("   Waktu      : %.6f detik\n", time_taken);
     printf("   Speedup    : %.2fx\n", speedup_cilk);
+    printf("   Cutoff     : %d (spawn threshold)\n", cilk_cutoff);
     printf("   Model      : Work-Stealing Scheduler\n");
     printf("   P-D Bound  : T_P ≈ W/P + D\n\n");
 #endif
 
+    (void)warmup_result;
+    return baseline_time;
+}
+
+// ==================== Fast Doubling (6) ====================
+void run_fast_doubling(uint64_t n, uint64_t modulus, double baseline_time) {
+    printf("6. FAST DOUBLING (O(log n))\n");
+    printf("   ----------------------------------------\n");
+
+    if (n <= FIB_U128_MAX_N) {
+        char digits[48];
+        const long reps = 100000; // satu panggilan hanya puluhan ns: dirata-rata
+        volatile uint64_t sink = 0;
+        double start = get_wall_time();
+        for (long r = 0; r < reps; r++) {
+            sink ^= n <= FIB_U64_MAX_N ? fib_fast_doubling_u64(n)
+                                       : (uint64_t)fib_fast_doubling_u128(n);
+        }
+        double time_taken = (get_wall_time() - start) / reps;
+        (void)sink;
+
+        if (n <= FIB_U64_MAX_N) {
+            snprintf(digits, sizeof(digits), "%llu", (unsigned long long)fib_fast_doubling_u64(n));
+        } else {
+            uint128_to_string(fib_fast_doubling_u128(n), digits);
+        }
+        printf("   Hasil      : %s (%d-bit)\n", digits, n <= FIB_U64_MAX_N ? 64 : 128);
+        printf("   Waktu      : %.9f detik (rata-rata %ld panggilan)\n", time_taken, reps);
+        if (baseline_time > 0.0 && time_taken > 0.0) {
+            printf("   Speedup    : %.2fx\n", baseline_time / time_taken);
+        }
+    } else {
+        printf("   Hasil      : F(n) melebihi 128-bit (n > %d), gunakan mod\n", FIB_U128_MAX_N);
+    }
+
+    if (modulus != 0) {
+        printf("   Mod %-7llu: %llu\n", (unsigned long long)modulus,
+               (unsigned long long)fib_fast_doubling_mod(n, modulus));
+    }
+    printf("   Model      : F(2k) = F(k)(2F(k+1) - F(k)), F(2k+1) = F(k)^2 + F(k+1)^2\n\n");
+}
+
+// Parse bilangan desimal tak bertanda 64-bit; return 0 jika tidak valid
+int parse_u64(const char* text, uint64_t* out) {
+    char* end;
+    if (!text || !*text || *text == '-') return 0;
+    unsigned long long v = strtoull(text, &end, 10);
+    if (*end != '\0') return 0;
+    *out = (uint64_t)v;
+    return 1;
+}
+
+// ==================== Main Program ====================
+int main(int argc, char *argv[]) {
+    uint64_t n = 35; // Default value
+    uint64_t modulus = 0; // --mod=m: juga hitung F(n) mod m
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--cutoff=", 9) == 0) {
+            int cutoff = atoi(argv[i] + 9);
+            if (cutoff < 2) {
+                fprintf(stderr, "Cutoff tidak valid: %s\n", argv[i] + 9);
+                return 1;
+            }
+#ifdef USE_OPENMP
+            omp_cutoff = cutoff;
+#endif
+#ifdef USE_CILK
+            cilk_cutoff = cutoff;
+#endif
+            (void)cutoff;
+        } else if (strncmp(argv[i], "--mod=", 6) == 0) {
+            if (!parse_u64(argv[i] + 6, &modulus) || modulus == 0) {
+                fprintf(stderr, "Modulus tidak valid: %s\n", argv[i] + 6);
+                return 1;
+            }
+        } else if (!parse_u64(argv[i], &n)) {
+            fprintf(stderr, "n tidak valid: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    
+    printf("==================================================================\n");
+    printf("        PERBANDINGAN FIBONACCI: SERIAL vs PARALLEL               \n");
+    printf("==================================================================\n");
+    printf("Menghitung Fibonacci ke-%llu\n", (unsigned long long)n);
+    
+#ifdef USE_OPENMP
+    printf("Jumlah thread yang tersedia: %d\n", omp_get_max_threads());
+#endif
+    
+    printf("==================================================================\n");
+
+    double baseline_time = 0.0;
+    if (n <= RECURSIVE_MAX_N) {
+        baseline_time = run_recursive_variants((int)n);
+    } else {
+        printf("\n[Info] n > %d: varian rekursif (int 32-bit, O(phi^n)) dilewati\n\n",
+               RECURSIVE_MAX_N);
+    }
+    run_fast_doubling(n, modulus, baseline_time);
+
     // ============== Summary ==============
     printf("==================================================================\n");
     printf("                            RINGKASAN                             \n");
@@ -242,7 +425,9 @@ int main(int argc, char *argv[]) {
 #ifdef USE_CILK
     printf("│ Cilk Serial         │ Single thread, tanpa spawn               │\n");
     printf("│ Cilk Parallel       │ Multi-thread, Work-Stealing              │\n");
+    printf("├─────────────────────┼──────────────────────────────────────────┤\n");
 #endif
+    printf("│ Fast Doubling       │ O(log n), eksak 64/128-bit atau mod m    │\n");
     
     printf("└─────────────────────┴──────────────────────────────────────────┘\n\n");
     
@@ -256,13 +441,15 @@ int main(int argc, char *argv[]) {
 #ifdef USE_CILK
     printf("• OpenCilk    : Work-stealing efisien, load balancing dinamis\n");
 #endif
+    printf("• Fast Doubling: O(log n), mikrodetik untuk n berapa pun\n");
     
     printf("\n==================================================================\n");
     printf("Catatan:\n");
     printf("- Speedup = Waktu_Sequential / Waktu_Parallel\n");
     printf("- Efficiency = (Speedup / Jumlah_Thread) × 100%%\n");
-    printf("- Untuk hasil optimal, gunakan N >= 35\n");
-    printf("- Waktu diukur menggunakan wall-clock time (gettimeofday)\n");
+    printf("- Untuk hasil optimal, gunakan N >= 35 (varian rekursif hanya sampai N = %d)\n",
+           RECURSIVE_MAX_N);
+    printf("- Waktu diukur dengan clock_gettime(CLOCK_MONOTONIC_RAW)\n");
     printf("==================================================================\n");
     
     return 0;
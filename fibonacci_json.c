@@ -1,8 +1,25 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // cpu_set_t / sched_setaffinity (--cpus)
+#endif
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <time.h>
-#include <sys/time.h>
 #include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define TIMING_HAVE_TSC 1
+#endif
+
+// Varian rekursif memakai int 32-bit: F(46) masih muat, dan di atas ~45 waktunya
+// sudah puluhan detik, jadi hanya dijalankan sampai batas ini
+#define RECURSIVE_MAX_N 45
 
 // ==================== Sequential Implementation ====================
 int fib_sequential(int n) {
@@ -14,47 +31,58 @@ int fib_sequential(int n) {
 #ifdef USE_OPENMP
 #include <omp.h>
 
-#define CUTOFF 20
+#define CUTOFF 20 // default; bisa diganti --cutoff=N atau --autotune
 
-int fib_omp_task(int n) {
+// Cutoff dibawa sebagai argumen (bukan global) agar panggilan dari beberapa thread
+// addon dengan cutoff berbeda bisa berjalan bersamaan
+int fib_omp_task(int n, int cutoff) {
     if (n < 2) return n;
-    if (n < CUTOFF) {
+    if (n < cutoff) {
         return fib_sequential(n);
     }
     
     int x, y;
     #pragma omp task shared(x)
     {
-        x = fib_omp_task(n - 1);
+        x = fib_omp_task(n - 1, cutoff);
     }
-    y = fib_omp_task(n - 2);
+    y = fib_omp_task(n - 2, cutoff);
     #pragma omp taskwait
     
     return x + y;
 }
 
-int fibonacci_openmp_parallel(int n) {
+int fibonacci_openmp_parallel(int n, int cutoff) {
     int result = 0;
     #pragma omp parallel
     {
         #pragma omp single
         {
-            result = fib_omp_task(n);
+            result = fib_omp_task(n, cutoff);
         }
     }
     return result;
 }
+
+// OpenMP Sequential (tanpa tasking)
+int fibonacci_openmp_serial(int n) {
+    return fib_sequential(n);
+}
 #endif
 
 // ==================== OpenCilk Implementation ====================
 #ifdef USE_CILK
 #include <cilk/cilk.h>
 
-#define CILK_CUTOFF 20
+#include <cilk/cilk_api.h>
+
+#define CILK_CUTOFF 20 // default; bisa diganti --cutoff=N atau --autotune
+
+static int cilk_cutoff = CILK_CUTOFF;
 
 int fib_cilk_task(int n) {
     if (n < 2) return n;
-    if (n < CILK_CUTOFF) {
+    if (n < cilk_cutoff) {
         return fib_sequential(n);
     }
     
@@ -71,124 +99,2031 @@ int fibonacci_cilk_parallel(int n) {
 }
 #endif
 
-double get_wall_time() {
-    struct timeval time;
-    gettimeofday(&time, NULL);
-    return (double)time.tv_sec + (double)time.tv_usec * 0.000001;
+// ==================== CPU Budget (--threads / --cpus) ====================
+// Server membagi core antar job yang berjalan bersamaan: --threads=N membatasi
+// jumlah thread OpenMP dan worker work-stealing, --cpus=LIST ("0-3,6") mengikat
+// thread pemanggil, tim OpenMP, dan worker work-stealing ke core tersebut (Linux;
+// di OS lain hanya --threads yang berlaku). Mode worker mengembalikan setelan
+// default proses di awal setiap request.
+#define CPU_LIST_MAX 128 // panjang teks --cpus
+
+static int cpu_default_threads = 0;  // omp_get_max_threads() saat request pertama
+static int cpu_mask_generation = 0;  // naik setiap mask berubah (pool ws dibuat ulang)
+#if defined(__linux__)
+static cpu_set_t cpu_default_mask;
+static cpu_set_t cpu_current_mask;
+static int cpu_default_saved = 0;
+static int cpu_allowed[CPU_SETSIZE]; // CPU di mask default, urut naik
+static int cpu_allowed_count = 0;
+
+// Parse "0-3,6,8-9" ke cpu_set_t; return jumlah core atau -1 jika tidak valid.
+// Angka adalah indeks ke CPU yang diizinkan untuk proses (cpuset container bisa
+// mulai dari CPU 4, dst.), modulo jumlahnya, sama dengan penomoran core di server
+static int cpu_parse_list(const char* spec, cpu_set_t* set) {
+    CPU_ZERO(set);
+    const char* p = spec;
+    while (*p) {
+        char* end;
+        long lo = strtol(p, &end, 10), hi = lo;
+        if (end == p || lo < 0) return -1;
+        p = end;
+        if (*p == '-') {
+            hi = strtol(p + 1, &end, 10);
+            if (end == p + 1 || hi < lo) return -1;
+            p = end;
+        }
+        if (hi >= CPU_SETSIZE) return -1;
+        for (long c = lo; c <= hi; c++) CPU_SET(cpu_allowed[c % cpu_allowed_count], set);
+        if (*p == ',') p++;
+        else if (*p) return -1;
+    }
+    return CPU_COUNT(set);
 }
 
-// Normalize timing to avoid zero/NaN in JSON output
-double normalize_time(double t) {
-    const double min_time = 1e-9;
-    if (t < min_time) return min_time;
-    return t;
+// Ikat thread pemanggil dan (jika ada) tim OpenMP ke mask
+static void cpu_bind(const cpu_set_t* set, int threads) {
+    if (memcmp(set, &cpu_current_mask, sizeof(cpu_set_t)) != 0) {
+        cpu_current_mask = *set;
+        cpu_mask_generation++;
+    }
+    sched_setaffinity(0, sizeof(cpu_set_t), set);
+#ifdef USE_OPENMP
+    // Thread tim dipakai ulang oleh libgomp antar region: cukup di-pin sekali di sini
+    #pragma omp parallel num_threads(threads)
+    {
+        sched_setaffinity(0, sizeof(cpu_set_t), set);
+    }
+#else
+    (void)threads;
+#endif
 }
+#endif
 
-double safe_ratio(double num, double den) {
-    double n = normalize_time(num);
-    double d = normalize_time(den);
-    double r = n / d;
-    if (!isfinite(r) || r < 0) return 0.0;
-    return r;
+// Terapkan budget satu invocation. threads = 0 dan cpus = NULL -> default proses.
+// Return jumlah thread efektif, atau -1 jika --cpus tidak valid
+int cpu_budget_apply(int threads, const char* cpus) {
+#ifdef USE_OPENMP
+    if (cpu_default_threads == 0) cpu_default_threads = omp_get_max_threads();
+#else
+    if (cpu_default_threads == 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        cpu_default_threads = n > 0 ? (int)n : 1;
+    }
+#endif
+#if defined(__linux__)
+    if (!cpu_default_saved) {
+        sched_getaffinity(0, sizeof(cpu_set_t), &cpu_default_mask);
+        cpu_current_mask = cpu_default_mask;
+        for (int c = 0; c < CPU_SETSIZE; c++) {
+            if (CPU_ISSET(c, &cpu_default_mask)) cpu_allowed[cpu_allowed_count++] = c;
+        }
+        cpu_default_saved = 1;
+    }
+    cpu_set_t set = cpu_default_mask;
+    if (cpus) {
+        int count = cpu_parse_list(cpus, &set);
+        if (count <= 0) return -1;
+        if (threads == 0) threads = count;
+    }
+#else
+    (void)cpus;
+#endif
+    if (threads == 0) threads = cpu_default_threads;
+#ifdef USE_OPENMP
+    omp_set_num_threads(threads);
+#endif
+#if defined(__linux__)
+    cpu_bind(&set, threads);
+#endif
+    return threads;
 }
 
-int main(int argc, char *argv[]) {
-    int N = 35;
-    if (argc > 1) {
-        N = atoi(argv[1]);
+// ==================== Work-Stealing Runtime (pthreads) ====================
+// Backend ketiga tanpa compiler OpenCilk: setiap worker punya deque Chase-Lev
+// (pemilik push/take di bottom tanpa lock, pencuri steal dari top dengan CAS).
+// API spawn/sync gaya Cilk: ws_spawn() menaruh task di deque sendiri, ws_sync()
+// mengambilnya kembali bila belum dicuri; bila sudah dicuri, worker ikut mencuri
+// task lain sampai task tersebut selesai. Task dialokasikan di stack pemanggil
+// (aman karena ws_sync selalu dipanggil sebelum fungsi kembali).
+#define WS_DEQUE_CAPACITY 4096 // task tertunda per worker (kedalaman rekursi)
+#define WS_MAX_WORKERS 256
+
+typedef struct WsTask {
+    void (*fn)(void*);
+    void* arg;
+    atomic_int done;
+} WsTask;
+
+typedef struct {
+    atomic_long top;
+    atomic_long bottom;
+    _Atomic(WsTask*) buf[WS_DEQUE_CAPACITY];
+} WsDeque;
+
+typedef struct {
+    WsDeque deque;
+    pthread_t thread;
+    unsigned rng;
+    long steals;         // steal sukses
+    long steal_attempts;
+    long tasks;          // task yang dieksekusi worker ini (inline + curian)
+    double idle_time;    // detik mencari kerja tanpa hasil
+    char pad[64];        // hindari false sharing antar worker
+} WsWorker;
+
+typedef struct {
+    WsWorker* workers;
+    int num_workers;
+    atomic_int active;   // 1 selama ws_run berjalan
+    atomic_int busy;     // worker yang sedang di loop curi
+    atomic_int shutdown;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    int cpu_generation;  // cpu_mask_generation saat worker dibuat (mewarisi affinity)
+} WsPool;
+
+static WsPool ws_pool;
+static _Thread_local int ws_self = -1;
+
+static double ws_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Pemilik: push di bottom; return 0 jika deque penuh
+static int ws_push(WsDeque* q, WsTask* t) {
+    long b = atomic_load_explicit(&q->bottom, memory_order_relaxed);
+    long top = atomic_load_explicit(&q->top, memory_order_acquire);
+    if (b - top >= WS_DEQUE_CAPACITY) return 0;
+    atomic_store_explicit(&q->buf[b % WS_DEQUE_CAPACITY], t, memory_order_relaxed);
+    // release: isi task terlihat oleh pencuri yang membaca bottom dengan acquire
+    atomic_store_explicit(&q->bottom, b + 1, memory_order_release);
+    return 1;
+}
+
+// Pemilik: ambil dari bottom (LIFO); NULL jika kosong / kalah race elemen terakhir
+static WsTask* ws_take(WsDeque* q) {
+    long b = atomic_load_explicit(&q->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&q->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&q->top, memory_order_relaxed);
+    WsTask* x = NULL;
+    if (t <= b) {
+        x = atomic_load_explicit(&q->buf[b % WS_DEQUE_CAPACITY], memory_order_relaxed);
+        if (t == b) {
+            if (!atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1,
+                                                         memory_order_seq_cst,
+                                                         memory_order_relaxed)) {
+                x = NULL;
+            }
+            atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+        }
+    } else {
+        atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
     }
-    
-    volatile int warmup_result = fib_sequential(N);
-    
-    double start, end, time_taken;
+    return x;
+}
+
+// Pencuri: ambil dari top (FIFO, task tertua = sub-pohon terbesar)
+static WsTask* ws_steal(WsDeque* q) {
+    long t = atomic_load_explicit(&q->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&q->bottom, memory_order_acquire);
+    if (t >= b) return NULL;
+    WsTask* x = atomic_load_explicit(&q->buf[t % WS_DEQUE_CAPACITY], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1,
+                                                 memory_order_seq_cst,
+                                                 memory_order_relaxed)) {
+        return NULL;
+    }
+    return x;
+}
+
+static void ws_execute(WsWorker* w, WsTask* t) {
+    t->fn(t->arg);
+    w->tasks++;
+    atomic_store_explicit(&t->done, 1, memory_order_release);
+}
+
+// Satu putaran mencuri dari korban acak; NULL jika semua deque kosong
+static WsTask* ws_find_task(int self) {
+    WsWorker* w = &ws_pool.workers[self];
+    int n = ws_pool.num_workers;
+    if (n < 2) return NULL;
+    w->rng = w->rng * 1103515245u + 12345u;
+    int start = (int)((w->rng >> 16) % (unsigned)n);
+    for (int k = 0; k < n; k++) {
+        int victim = (start + k) % n;
+        if (victim == self) continue;
+        w->steal_attempts++;
+        WsTask* t = ws_steal(&ws_pool.workers[victim].deque);
+        if (t) {
+            w->steals++;
+            return t;
+        }
+    }
+    return NULL;
+}
+
+void ws_spawn(WsTask* t) {
+    WsWorker* w = &ws_pool.workers[ws_self];
+    atomic_store_explicit(&t->done, 0, memory_order_relaxed);
+    if (!ws_push(&w->deque, t)) {
+        ws_execute(w, t); // deque penuh: jalankan langsung
+    }
+}
+
+void ws_sync(WsTask* t) {
+    WsWorker* w = &ws_pool.workers[ws_self];
+    if (atomic_load_explicit(&t->done, memory_order_acquire)) return;
+    // Task terakhir yang di-spawn ada di bottom kecuali sudah dicuri
+    WsTask* x = ws_take(&w->deque);
+    if (x == t) {
+        ws_execute(w, t);
+        return;
+    }
+    if (x) { // tidak terjadi untuk pola spawn/sync bersarang, tapi tetap aman
+        ws_execute(w, x);
+    }
+    // Dicuri: bantu kerjakan task lain sampai task ini selesai
+    double idle_start = 0.0;
+    while (!atomic_load_explicit(&t->done, memory_order_acquire)) {
+        WsTask* other = ws_find_task(ws_self);
+        if (other) {
+            if (idle_start > 0.0) {
+                w->idle_time += ws_now() - idle_start;
+                idle_start = 0.0;
+            }
+            ws_execute(w, other);
+        } else if (idle_start == 0.0) {
+            idle_start = ws_now();
+        }
+    }
+    if (idle_start > 0.0) w->idle_time += ws_now() - idle_start;
+}
+
+static void* ws_worker_main(void* arg) {
+    int self = (int)(intptr_t)arg;
+    WsWorker* w = &ws_pool.workers[self];
+    ws_self = self;
+    for (;;) {
+        pthread_mutex_lock(&ws_pool.lock);
+        while (!atomic_load(&ws_pool.active) && !atomic_load(&ws_pool.shutdown)) {
+            pthread_cond_wait(&ws_pool.wake, &ws_pool.lock);
+        }
+        // busy dinaikkan di bawah lock agar ws_run tahu worker ini ikut run
+        if (!atomic_load(&ws_pool.shutdown)) atomic_fetch_add(&ws_pool.busy, 1);
+        pthread_mutex_unlock(&ws_pool.lock);
+        if (atomic_load(&ws_pool.shutdown)) break;
+
+        double idle_start = ws_now();
+        while (atomic_load_explicit(&ws_pool.active, memory_order_acquire)) {
+            WsTask* t = ws_find_task(self);
+            if (t) {
+                w->idle_time += ws_now() - idle_start;
+                ws_execute(w, t);
+                idle_start = ws_now();
+            } else {
+                sched_yield();
+            }
+        }
+        w->idle_time += ws_now() - idle_start;
+        atomic_fetch_sub_explicit(&ws_pool.busy, 1, memory_order_release);
+    }
+    return NULL;
+}
+
+// Buat pool num_workers (thread pemanggil = worker 0); return 0 jika sukses
+int ws_init(int num_workers) {
+    if (num_workers < 1) num_workers = 1;
+    if (num_workers > WS_MAX_WORKERS) num_workers = WS_MAX_WORKERS;
+    ws_pool.workers = calloc((size_t)num_workers, sizeof(WsWorker));
+    if (!ws_pool.workers) return -1;
+    ws_pool.num_workers = num_workers;
+    atomic_store(&ws_pool.active, 0);
+    atomic_store(&ws_pool.busy, 0);
+    atomic_store(&ws_pool.shutdown, 0);
+    pthread_mutex_init(&ws_pool.lock, NULL);
+    pthread_cond_init(&ws_pool.wake, NULL);
+    for (int i = 0; i < num_workers; i++) ws_pool.workers[i].rng = 0x9E3779B9u * (unsigned)(i + 1);
+    ws_pool.cpu_generation = cpu_mask_generation;
+    ws_self = 0;
+    for (int i = 1; i < num_workers; i++) {
+        if (pthread_create(&ws_pool.workers[i].thread, NULL, ws_worker_main,
+                           (void*)(intptr_t)i) != 0) {
+            ws_pool.num_workers = i; // jalan dengan worker yang berhasil dibuat
+            break;
+        }
+    }
+    return 0;
+}
+
+// Jalankan root di worker 0 sementara worker lain mencuri; kembali setelah selesai
+void ws_run(void (*fn)(void*), void* arg) {
+    ws_self = 0; // thread pemanggil bisa berbeda dari pembuat pool (addon Node)
+    pthread_mutex_lock(&ws_pool.lock);
+    atomic_store(&ws_pool.active, 1);
+    pthread_cond_broadcast(&ws_pool.wake);
+    pthread_mutex_unlock(&ws_pool.lock);
+
+    WsTask root;
+    root.fn = fn;
+    root.arg = arg;
+    atomic_init(&root.done, 0);
+    ws_execute(&ws_pool.workers[0], &root);
+
+    // Tunggu semua worker keluar dari loop curi agar statistik stabil
+    pthread_mutex_lock(&ws_pool.lock);
+    atomic_store(&ws_pool.active, 0);
+    pthread_mutex_unlock(&ws_pool.lock);
+    while (atomic_load_explicit(&ws_pool.busy, memory_order_acquire) > 0) {
+        sched_yield();
+    }
+}
+
+void ws_reset_stats(void) {
+    for (int i = 0; i < ws_pool.num_workers; i++) {
+        WsWorker* w = &ws_pool.workers[i];
+        w->steals = w->steal_attempts = w->tasks = 0;
+        w->idle_time = 0.0;
+    }
+}
+
+void ws_shutdown(void) {
+    pthread_mutex_lock(&ws_pool.lock);
+    atomic_store(&ws_pool.shutdown, 1);
+    pthread_cond_broadcast(&ws_pool.wake);
+    pthread_mutex_unlock(&ws_pool.lock);
+    for (int i = 1; i < ws_pool.num_workers; i++) pthread_join(ws_pool.workers[i].thread, NULL);
+    pthread_mutex_destroy(&ws_pool.lock);
+    pthread_cond_destroy(&ws_pool.wake);
+    free(ws_pool.workers);
+    ws_pool.workers = NULL;
+    ws_pool.num_workers = 0;
+}
+
+// Pool dengan num_workers worker; pool yang sudah ada dipakai ulang bila jumlahnya
+// dan mask CPU-nya sama (mode worker: thread tetap hidup antar request)
+int ws_ensure(int num_workers) {
+    if (ws_pool.workers && ws_pool.num_workers == num_workers &&
+        ws_pool.cpu_generation == cpu_mask_generation) return 0;
+    if (ws_pool.workers) ws_shutdown();
+    return ws_init(num_workers);
+}
+
+#define WS_CUTOFF 20 // default; bisa diganti --cutoff=N atau --autotune
+
+typedef struct {
+    int n;
+    int cutoff;
     int result;
-    
-    start = get_wall_time();
-    result = fib_sequential(N);
-    end = get_wall_time();
-    time_taken = normalize_time(end - start);
-    double baseline_time = time_taken;
-    
-    int num_threads = 1;
-    double speedup_omp = 0.0;
-    double efficiency_omp = 0.0;
-    double speedup_cilk = 0.0;
-    
+} WsFibArgs;
+
+int fib_ws_task(int n, int cutoff);
+
+static void fib_ws_entry(void* p) {
+    WsFibArgs* a = p;
+    a->result = fib_ws_task(a->n, a->cutoff);
+}
+
+int fib_ws_task(int n, int cutoff) {
+    if (n < 2) return n;
+    if (n < cutoff) {
+        return fib_sequential(n);
+    }
+
+    WsFibArgs x = { n - 1, cutoff, 0 };
+    WsTask t;
+    t.fn = fib_ws_entry;
+    t.arg = &x;
+    ws_spawn(&t);
+    int y = fib_ws_task(n - 2, cutoff);
+    ws_sync(&t);
+
+    return x.result + y;
+}
+
+int fibonacci_worksteal_parallel(int n, int cutoff) {
+    WsFibArgs root = { n, cutoff, 0 };
+    ws_run(fib_ws_entry, &root);
+    return root.result;
+}
+
+// ==================== Fast Doubling (O(log n)) ====================
+// F(2k)   = F(k) * (2*F(k+1) - F(k))
+// F(2k+1) = F(k)^2 + F(k+1)^2
+// Bit n diproses dari MSB; aritmetika unsigned wrap-around tetap benar modulo
+// 2^64 / 2^128, sehingga hasil eksak selama F(n) muat di tipe tersebut.
+#define FIB_U64_MAX_N 93   // F(93)  < 2^64  <= F(94)
+#define FIB_U128_MAX_N 186 // F(186) < 2^128 <= F(187)
+
+typedef unsigned __int128 uint128_t;
+
+uint64_t fib_fast_doubling_u64(uint64_t n) {
+    uint64_t a = 0, b = 1; // F(k), F(k+1)
+    for (int bit = 63; bit >= 0; bit--) {
+        uint64_t c = a * (2 * b - a);
+        uint64_t d = a * a + b * b;
+        if ((n >> bit) & 1) {
+            a = d;
+            b = c + d;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return a;
+}
+
+uint128_t fib_fast_doubling_u128(uint64_t n) {
+    uint128_t a = 0, b = 1;
+    for (int bit = 63; bit >= 0; bit--) {
+        uint128_t c = a * (2 * b - a);
+        uint128_t d = a * a + b * b;
+        if ((n >> bit) & 1) {
+            a = d;
+            b = c + d;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return a;
+}
+
+// F(n) mod m untuk n berapa pun (m >= 1); perkalian lewat 128-bit agar tidak overflow
+uint64_t fib_fast_doubling_mod(uint64_t n, uint64_t m) {
+    uint64_t a = 0, b = 1 % m;
+    for (int bit = 63; bit >= 0; bit--) {
+        uint64_t t = (uint64_t)(((uint128_t)2 * b + m - a) % m);
+        uint64_t c = (uint64_t)((uint128_t)a * t % m);
+        uint64_t d = (uint64_t)(((uint128_t)a * a % m + (uint128_t)b * b % m) % m);
+        if ((n >> bit) & 1) {
+            a = d;
+            b = (uint64_t)(((uint128_t)c + d) % m);
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return a;
+}
+
+// Desimal uint128 (printf tidak punya format untuk __int128)
+void uint128_to_string(uint128_t v, char* buf) {
+    char tmp[40];
+    int len = 0;
+    do {
+        tmp[len++] = (char)('0' + (int)(v % 10));
+        v /= 10;
+    } while (v);
+    for (int i = 0; i < len; i++) buf[i] = tmp[len - 1 - i];
+    buf[len] = '\0';
+}
+
+// ==================== BigInt Fast Doubling (presisi sembarang) ====================
+// Bilangan disimpan sebagai limb basis 10^9 (uint32_t, little-endian) sehingga
+// konversi ke desimal cukup mencetak per limb. Algoritma perkalian dipilih dari
+// ukuran operand: schoolbook (kecil), Karatsuba (menengah), NTT 3-prima + CRT
+// (besar). Tiga perkalian independen per langkah fast doubling, cabang Karatsuba
+// dan transform per prima dijalankan sebagai OpenMP task seperti fib_omp_task.
+// Memori habis tidak mematikan proses (addon berjalan di dalam Node): alokasi gagal
+// dilaporkan sebagai -1 / BigInt dengan d == NULL sampai ke fib_bigint.
+#define BIG_BASE 1000000000u
+#define BIG_BASE_DIGITS 9
+#define KARATSUBA_CUTOFF 48    // limb: di bawah ini schoolbook
+#define NTT_CUTOFF 1024        // limb: operand terkecil >= ini memakai NTT
+#define BIG_TASK_CUTOFF 2048   // limb: perkalian sebesar ini dipecah jadi task
+#define NTT_MAX_LOG 25         // panjang transform maks 2^25 (dibatasi prima ke-2 & ke-3)
+#define BIGINT_MAX_N 500000000ULL // F(n) ~ 0.209n digit; batas memori/panjang NTT
+#define BIG_SUMMARY_DIGITS 20  // digit awal/akhir pada output ringkas
+
+typedef struct {
+    uint32_t* d;
+    size_t n; // limb terpakai, tanpa nol di depan (0 = bilangan nol)
+} BigInt;
+
+// Prima NTT: p = c * 2^k + 1 dengan akar primitif g
+static const uint32_t NTT_PRIMES[3] = { 469762049u, 167772161u, 2113929217u };
+static const uint32_t NTT_ROOTS[3] = { 3u, 3u, 5u };
+
+// Limb nol sebanyak n; NULL jika memori habis
+uint32_t* big_limbs(size_t n) {
+    return calloc(n ? n : 1, sizeof(uint32_t));
+}
+
+void big_free(BigInt* x) {
+    free(x->d);
+    x->d = NULL;
+    x->n = 0;
+}
+
+static size_t limbs_trim(const uint32_t* d, size_t n) {
+    while (n && d[n - 1] == 0) n--;
+    return n;
+}
+
+// r[0..rn) += a[0..an); r harus cukup panjang untuk hasil
+static void limbs_add_into(uint32_t* r, size_t rn, const uint32_t* a, size_t an) {
+    an = limbs_trim(a, an);
+    uint32_t carry = 0;
+    size_t i = 0;
+    for (; i < an; i++) {
+        uint32_t s = r[i] + a[i] + carry;
+        carry = s >= BIG_BASE;
+        r[i] = carry ? s - BIG_BASE : s;
+    }
+    for (; carry && i < rn; i++) {
+        uint32_t s = r[i] + 1;
+        carry = s >= BIG_BASE;
+        r[i] = carry ? 0 : s;
+    }
+}
+
+// r[0..rn) -= a[0..an); syarat r >= a
+static void limbs_sub_into(uint32_t* r, size_t rn, const uint32_t* a, size_t an) {
+    an = limbs_trim(a, an);
+    uint32_t borrow = 0;
+    size_t i = 0;
+    for (; i < an; i++) {
+        int64_t s = (int64_t)r[i] - a[i] - borrow;
+        borrow = s < 0;
+        r[i] = (uint32_t)(borrow ? s + BIG_BASE : s);
+    }
+    for (; borrow && i < rn; i++) {
+        borrow = r[i] == 0;
+        r[i] = borrow ? BIG_BASE - 1 : r[i] - 1;
+    }
+}
+
+// out[0..na+nb) += a * b, O(na * nb)
+static void mul_schoolbook(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+    for (size_t i = 0; i < na; i++) {
+        uint64_t ai = a[i], carry = 0;
+        if (!ai) continue;
+        for (size_t j = 0; j < nb; j++) {
+            uint64_t cur = out[i + j] + ai * b[j] + carry;
+            out[i + j] = (uint32_t)(cur % BIG_BASE);
+            carry = cur / BIG_BASE;
+        }
+        for (size_t k = i + nb; carry; k++) {
+            uint64_t cur = out[k] + carry;
+            out[k] = (uint32_t)(cur % BIG_BASE);
+            carry = cur / BIG_BASE;
+        }
+    }
+}
+
+static uint32_t pow_mod(uint32_t base, uint64_t e, uint32_t p) {
+    uint64_t r = 1, b = base % p;
+    while (e) {
+        if (e & 1) r = r * b % p;
+        b = b * b % p;
+        e >>= 1;
+    }
+    return (uint32_t)r;
+}
+
+// NTT in-place (iteratif, bit-reversal), panjang n = 2^k; -1 jika memori habis
+static int ntt_transform(uint32_t* a, size_t n, uint32_t p, uint32_t g, int invert) {
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            uint32_t t = a[i];
+            a[i] = a[j];
+            a[j] = t;
+        }
+    }
+    // Tabel akar untuk stage terbesar; stage lebih kecil memakai stride
+    uint32_t* roots = big_limbs(n / 2 > 0 ? n / 2 : 1);
+    if (!roots) return -1;
+    uint32_t w = pow_mod(g, (p - 1) / n, p);
+    if (invert) w = pow_mod(w, p - 2, p);
+    roots[0] = 1;
+    for (size_t i = 1; i < n / 2; i++) roots[i] = (uint32_t)((uint64_t)roots[i - 1] * w % p);
+
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len / 2, stride = n / len;
+        for (size_t i = 0; i < n; i += len) {
+            for (size_t j = 0; j < half; j++) {
+                uint32_t u = a[i + j];
+                uint32_t v = (uint32_t)((uint64_t)a[i + j + half] * roots[j * stride] % p);
+                a[i + j] = u + v >= p ? u + v - p : u + v;
+                a[i + j + half] = u >= v ? u - v : u + p - v;
+            }
+        }
+    }
+    free(roots);
+
+    if (invert) {
+        uint64_t n_inv = pow_mod((uint32_t)(n % p), p - 2, p);
+        for (size_t i = 0; i < n; i++) a[i] = (uint32_t)(a[i] * n_inv % p);
+    }
+    return 0;
+}
+
+// Konvolusi a*b modulo satu prima; hasil di res (panjang n)
+static int ntt_convolve_prime(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+                              size_t n, int k, uint32_t* res) {
+    uint32_t p = NTT_PRIMES[k], g = NTT_ROOTS[k];
+    int square = a == b && na == nb;
+    for (size_t i = 0; i < na; i++) res[i] = a[i] % p;
+    if (ntt_transform(res, n, p, g, 0) != 0) return -1;
+    if (square) {
+        for (size_t i = 0; i < n; i++) res[i] = (uint32_t)((uint64_t)res[i] * res[i] % p);
+    } else {
+        uint32_t* fb = big_limbs(n);
+        if (!fb) return -1;
+        for (size_t i = 0; i < nb; i++) fb[i] = b[i] % p;
+        if (ntt_transform(fb, n, p, g, 0) != 0) {
+            free(fb);
+            return -1;
+        }
+        for (size_t i = 0; i < n; i++) res[i] = (uint32_t)((uint64_t)res[i] * fb[i] % p);
+        free(fb);
+    }
+    return ntt_transform(res, n, p, g, 1);
+}
+
+// out[0..na+nb) = a * b lewat NTT di 3 prima + CRT (Garner) lalu carry basis 10^9.
+// Koefisien konvolusi < min(na,nb) * 10^18, jauh di bawah p1*p2*p3 ~ 1.7e26.
+static int mul_ntt(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+    size_t n = 1;
+    while (n < na + nb - 1) n <<= 1;
+    uint32_t* res[3];
+    int err[3] = { 0, 0, 0 };
+    for (int k = 0; k < 3; k++) res[k] = big_limbs(n);
+    if (!res[0] || !res[1] || !res[2]) {
+        for (int k = 0; k < 3; k++) free(res[k]);
+        return -1;
+    }
+
+    for (int k = 0; k < 3; k++) {
+        #pragma omp task firstprivate(k) shared(err) if (n >= 2 * BIG_TASK_CUTOFF)
+        err[k] = ntt_convolve_prime(a, na, b, nb, n, k, res[k]);
+    }
+    #pragma omp taskwait
+    if (err[0] || err[1] || err[2]) {
+        for (int k = 0; k < 3; k++) free(res[k]);
+        return -1;
+    }
+
+    const uint64_t m1 = NTT_PRIMES[0], m2 = NTT_PRIMES[1], m3 = NTT_PRIMES[2];
+    const uint64_t inv_m1_m2 = pow_mod((uint32_t)(m1 % m2), m2 - 2, (uint32_t)m2);
+    const uint64_t inv_m1m2_m3 = pow_mod((uint32_t)(m1 * m2 % m3), m3 - 2, (uint32_t)m3);
+    const uint128_t m1m2 = (uint128_t)m1 * m2;
+    uint128_t carry = 0;
+    size_t total = na + nb;
+    for (size_t i = 0; i < total; i++) {
+        uint128_t x = carry;
+        if (i < na + nb - 1) {
+            uint64_t r1 = res[0][i], r2 = res[1][i], r3 = res[2][i];
+            uint64_t v2 = (r2 + m2 - r1 % m2) % m2 * inv_m1_m2 % m2;
+            uint64_t t = (r1 + v2 * m1) % m3;
+            uint64_t v3 = (r3 + m3 - t) % m3 * inv_m1m2_m3 % m3;
+            x += r1 + (uint128_t)v2 * m1 + (uint128_t)v3 * m1m2;
+        }
+        out[i] = (uint32_t)(x % BIG_BASE);
+        carry = x / BIG_BASE;
+    }
+    for (int k = 0; k < 3; k++) free(res[k]);
+    return 0;
+}
+
+static int mul_limbs(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out);
+
+// out[0..na+nb) = a * b (Karatsuba, out sudah nol); na >= nb. -1 jika memori habis
+static int mul_karatsuba(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+    if (2 * nb <= na) {
+        // Operand tidak seimbang: kalikan per potongan a sepanjang nb
+        uint32_t* tmp = big_limbs(2 * nb);
+        if (!tmp) return -1;
+        for (size_t off = 0; off < na; off += nb) {
+            size_t len = na - off < nb ? na - off : nb;
+            memset(tmp, 0, 2 * nb * sizeof(uint32_t));
+            if (mul_limbs(a + off, len, b, nb, tmp) != 0) {
+                free(tmp);
+                return -1;
+            }
+            limbs_add_into(out + off, na + nb - off, tmp, len + nb);
+        }
+        free(tmp);
+        return 0;
+    }
+
+    // a = a1*B^m + a0, b = b1*B^m + b0
+    // a*b = z2*B^2m + (z1 - z2 - z0)*B^m + z0, z1 = (a0 + a1)(b0 + b1)
+    size_t m = na / 2;
+    size_t n1a = na - m, n1b = nb - m;
+    uint32_t* z0 = big_limbs(2 * m);
+    uint32_t* z2 = big_limbs(n1a + n1b);
+    uint32_t* sa = big_limbs(n1a + 1);
+    uint32_t* sb = big_limbs(m + 1);
+    uint32_t* z1 = big_limbs(n1a + m + 2);
+    int e0 = 0, e1 = -1, e2 = 0; // e1 tetap -1 jika buffer di atas gagal dialokasikan
+
+    if (z0 && z2 && sa && sb && z1) {
+        #pragma omp task shared(e0) if (nb >= BIG_TASK_CUTOFF)
+        e0 = mul_limbs(a, m, b, m, z0);
+        #pragma omp task shared(e2) if (nb >= BIG_TASK_CUTOFF)
+        e2 = mul_limbs(a + m, n1a, b + m, n1b, z2);
+
+        memcpy(sa, a + m, n1a * sizeof(uint32_t));
+        limbs_add_into(sa, n1a + 1, a, m);
+        memcpy(sb, b, m * sizeof(uint32_t));
+        limbs_add_into(sb, m + 1, b + m, n1b);
+        e1 = mul_limbs(sa, n1a + 1, sb, m + 1, z1);
+        #pragma omp taskwait
+    }
+
+    if (!e0 && !e1 && !e2) {
+        limbs_sub_into(z1, n1a + m + 2, z0, 2 * m);
+        limbs_sub_into(z1, n1a + m + 2, z2, n1a + n1b);
+        limbs_add_into(out, na + nb, z0, 2 * m);
+        limbs_add_into(out + 2 * m, na + nb - 2 * m, z2, n1a + n1b);
+        limbs_add_into(out + m, na + nb - m, z1, n1a + m + 2);
+    }
+
+    free(z0);
+    free(z2);
+    free(sa);
+    free(sb);
+    free(z1);
+    return e0 || e1 || e2 ? -1 : 0;
+}
+
+// out[0..na+nb) = a * b (out sudah nol); pilih algoritma dari ukuran operand.
+// -1 jika memori habis (isi out tidak terpakai)
+static int mul_limbs(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+    na = limbs_trim(a, na);
+    nb = limbs_trim(b, nb);
+    if (!na || !nb) return 0;
+    if (na < nb) {
+        const uint32_t* t = a; a = b; b = t;
+        size_t tn = na; na = nb; nb = tn;
+    }
+    size_t ntt_len = 1;
+    while (ntt_len < na + nb - 1) ntt_len <<= 1;
+
+    if (nb < KARATSUBA_CUTOFF) {
+        mul_schoolbook(a, na, b, nb, out);
+        return 0;
+    }
+    if (nb >= NTT_CUTOFF && ntt_len <= ((size_t)1 << NTT_MAX_LOG)) {
+        return mul_ntt(a, na, b, nb, out);
+    }
+    return mul_karatsuba(a, na, b, nb, out);
+}
+
+// big_mul / big_add / big_sub: hasil dengan d == NULL jika memori habis atau salah
+// satu operand sudah gagal, sehingga kegagalan cukup diperiksa sekali per langkah
+BigInt big_mul(const BigInt* a, const BigInt* b) {
+    BigInt r = { NULL, 0 };
+    if (!a->d || !b->d) return r;
+    r.d = big_limbs(a->n + b->n);
+    if (r.d && mul_limbs(a->d, a->n, b->d, b->n, r.d) != 0) big_free(&r);
+    if (r.d) r.n = limbs_trim(r.d, a->n + b->n);
+    return r;
+}
+
+BigInt big_add(const BigInt* a, const BigInt* b) {
+    const BigInt* big = a->n >= b->n ? a : b;
+    const BigInt* small = a->n >= b->n ? b : a;
+    BigInt r = { NULL, 0 };
+    if (!a->d || !b->d) return r;
+    r.d = big_limbs(big->n + 1);
+    if (!r.d) return r;
+    memcpy(r.d, big->d, big->n * sizeof(uint32_t));
+    limbs_add_into(r.d, big->n + 1, small->d, small->n);
+    r.n = limbs_trim(r.d, big->n + 1);
+    return r;
+}
+
+// a - b dengan syarat a >= b
+BigInt big_sub(const BigInt* a, const BigInt* b) {
+    BigInt r = { NULL, 0 };
+    if (!a->d || !b->d) return r;
+    r.d = big_limbs(a->n);
+    if (!r.d) return r;
+    memcpy(r.d, a->d, a->n * sizeof(uint32_t));
+    limbs_sub_into(r.d, a->n, b->d, b->n);
+    r.n = limbs_trim(r.d, a->n);
+    return r;
+}
+
+/*
+ * F(n) presisi sembarang dengan fast doubling, dari bit tertinggi n:
+ *   t = 2F(k+1) - F(k); F(2k) = F(k) * t; F(2k+1) = F(k)^2 + F(k+1)^2
+ * Tiga perkalian per langkah saling bebas -> task. d == NULL jika memori habis.
+ */
+BigInt fib_bigint(uint64_t n) {
+    BigInt a = { big_limbs(1), 0 }; // F(0)
+    BigInt b = { big_limbs(1), 1 }; // F(1)
+    if (!a.d || !b.d) {
+        big_free(&a);
+        big_free(&b);
+        return a;
+    }
+    b.d[0] = 1;
+    int top = 63;
+    while (top >= 0 && !((n >> top) & 1)) top--;
+
+    for (int bit = top; bit >= 0; bit--) {
+        BigInt b2x = big_add(&b, &b);
+        BigInt t = big_sub(&b2x, &a);
+        BigInt c, a_sq, b_sq;
+        int par = b.n >= BIG_TASK_CUTOFF;
+
+        #pragma omp task shared(c) if (par)
+        c = big_mul(&a, &t);
+        #pragma omp task shared(a_sq) if (par)
+        a_sq = big_mul(&a, &a);
+        b_sq = big_mul(&b, &b);
+        #pragma omp taskwait
+
+        BigInt d = big_add(&a_sq, &b_sq);
+        big_free(&b2x);
+        big_free(&t);
+        big_free(&a_sq);
+        big_free(&b_sq);
+        big_free(&a);
+        big_free(&b);
+        if ((n >> bit) & 1) {
+            a = d;
+            b = big_add(&c, &d);
+            big_free(&c);
+        } else {
+            a = c;
+            b = d;
+        }
+        if (!a.d || !b.d) {
+            big_free(&a);
+            big_free(&b);
+            return a;
+        }
+    }
+    big_free(&b);
+    return a;
+}
+
+// Jalankan fib_bigint di dalam tim OpenMP agar task benar-benar paralel
+BigInt fibonacci_bigint(uint64_t n) {
+    BigInt r;
 #ifdef USE_OPENMP
-    num_threads = omp_get_max_threads();
+    #pragma omp parallel
+    {
+        #pragma omp single
+        r = fib_bigint(n);
+    }
+#else
+    r = fib_bigint(n);
 #endif
-    
-    printf("{\n");
-    printf("  \"n\": %d,\n", N);
-    printf("  \"sequential\": {\n");
-    printf("    \"name\": \"Pure Sequential\",\n");
-    printf("    \"result\": %d,\n", result);
-    printf("    \"time\": %.6f,\n", time_taken);
-    printf("    \"speedup\": 1.00,\n");
-    printf("    \"efficiency\": 100.00\n");
+    return r;
+}
+
+size_t big_digit_count(const BigInt* x) {
+    if (x->n == 0) return 1;
+    size_t digits = (size_t)(x->n - 1) * BIG_BASE_DIGITS;
+    for (uint32_t top = x->d[x->n - 1]; top; top /= 10) digits++;
+    return digits;
+}
+
+// Desimal lengkap (buffer dialokasikan, dilepas pemanggil dengan free)
+char* big_to_string(const BigInt* x) {
+    char* s = malloc(big_digit_count(x) + 1);
+    if (!s) return NULL;
+    if (x->n == 0) {
+        strcpy(s, "0");
+        return s;
+    }
+    char* p = s + sprintf(s, "%u", x->d[x->n - 1]);
+    for (size_t i = x->n - 1; i-- > 0;) {
+        p += sprintf(p, "%09u", x->d[i]);
+    }
+    return s;
+}
+
+// k digit pertama dan terakhir (k <= BIG_SUMMARY_DIGITS) tanpa membentuk string penuh
+void big_edge_digits(const BigInt* x, char* leading, char* trailing, int k) {
+    char buf[BIG_SUMMARY_DIGITS + 2 * BIG_BASE_DIGITS + 2];
+    size_t limbs = (size_t)k / BIG_BASE_DIGITS + 2;
+    if (x->n == 0) {
+        strcpy(leading, "0");
+        strcpy(trailing, "0");
+        return;
+    }
+
+    // Awal: limb teratas (tanpa padding) lalu limb berikutnya dengan padding
+    int len = sprintf(buf, "%u", x->d[x->n - 1]);
+    for (size_t i = x->n - 1; i-- > 0 && len < k;) {
+        len += sprintf(buf + len, "%09u", x->d[i]);
+    }
+    snprintf(leading, (size_t)k + 1, "%s", buf);
+
+    // Akhir: limb terbawah; limb teratas bilangan tidak di-padding
+    size_t lo = x->n < limbs ? x->n : limbs;
+    len = 0;
+    for (size_t i = lo; i-- > 0;) {
+        len += sprintf(buf + len, i == x->n - 1 ? "%u" : "%09u", x->d[i]);
+    }
+    strcpy(trailing, len > k ? buf + len - k : buf);
+}
+
+// ==================== Timing Engine ====================
+// Waktu diambil dari CLOCK_MONOTONIC_RAW (tidak ikut dikoreksi NTP), atau dari TSC
+// (--timer=tsc, hanya x86 dengan invariant TSC) yang dikalibrasi terhadap jam tsb.
+// timing_measure() menggandakan repetisi per sampel sampai satu sampel
+// >= timing_min_sample (jauh di atas resolusi timer), lalu mengambil beberapa sampel
+// dan melaporkan median waktu per panggilan beserta CI median dari order statistic.
+// Tidak ada clamp: waktu yang dilaporkan selalu hasil ukur.
+#define TIMING_MIN_SAMPLE 2e-3   // detik per sampel (default); --min-sample=S
+#define TIMING_MAX_TRIALS 11     // default jumlah sampel; --trials=N
+#define TIMING_TRIALS_LIMIT 101
+#define TIMING_MIN_TRIALS 3
+#define TIMING_BUDGET 1.0        // detik per varian; lewat ini berhenti di TIMING_MIN_TRIALS
+#define TIMING_TSC_CALIBRATION 20e-3
+
+#ifdef CLOCK_MONOTONIC_RAW
+#define TIMING_CLOCK CLOCK_MONOTONIC_RAW
+#define TIMING_CLOCK_NAME "monotonic_raw"
+#else
+#define TIMING_CLOCK CLOCK_MONOTONIC
+#define TIMING_CLOCK_NAME "monotonic"
+#endif
+
+typedef struct {
+    double median;    // detik per panggilan
+    double min;
+    double max;
+    double ci_low;    // CI median: [x_(k), x_(n-k+1)]
+    double ci_high;
+    double ci_level;  // cakupan CI sebenarnya untuk jumlah sampel ini
+    long repetitions; // panggilan per sampel
+    int trials;       // jumlah sampel
+    long calls;       // total panggilan termasuk auto-batching
+} Timing;
+
+// Per thread: CLI/worker mengaturnya di thread utama, addon per panggilan di thread
+// yang menjalankan timing_measure (fungsi yang diukur boleh membuka tim sendiri)
+static _Thread_local int timing_max_trials = TIMING_MAX_TRIALS;
+static _Thread_local double timing_min_sample = TIMING_MIN_SAMPLE;
+static int timer_use_tsc = 0;
+static double tsc_seconds_per_tick = 0.0;
+
+static double clock_seconds(void) {
+    struct timespec ts;
+    clock_gettime(TIMING_CLOCK, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Aktifkan TSC; return 0 jika tidak tersedia (tetap memakai jam monotonic).
+// Kalibrasi hanya sekali per proses (mode worker memanggil ini per request)
+int timer_enable_tsc(void) {
+#ifdef TIMING_HAVE_TSC
+    unsigned a, b, c, d;
+    if (tsc_seconds_per_tick > 0.0) {
+        timer_use_tsc = 1;
+        return 1;
+    }
+    // CPUID 0x80000007 EDX bit 8: invariant TSC (frekuensi konstan lintas P-state)
+    if (!__get_cpuid(0x80000007, &a, &b, &c, &d) || !((d >> 8) & 1)) return 0;
+    double c0 = clock_seconds();
+    uint64_t t0 = __rdtsc();
+    while (clock_seconds() - c0 < TIMING_TSC_CALIBRATION) {
+    }
+    double c1 = clock_seconds();
+    uint64_t t1 = __rdtsc();
+    if (t1 <= t0) return 0;
+    tsc_seconds_per_tick = (c1 - c0) / (double)(t1 - t0);
+    timer_use_tsc = 1;
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+double get_wall_time(void) {
+#ifdef TIMING_HAVE_TSC
+    if (timer_use_tsc) return (double)__rdtsc() * tsc_seconds_per_tick;
+#endif
+    return clock_seconds();
+}
+
+double timer_resolution(void) {
+    if (timer_use_tsc) return tsc_seconds_per_tick;
+    struct timespec res;
+    clock_getres(TIMING_CLOCK, &res);
+    return (double)res.tv_sec + (double)res.tv_nsec * 1e-9;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double timing_run(void (*fn)(void*), void* ctx, long reps) {
+    double start = get_wall_time();
+    for (long r = 0; r < reps; r++) fn(ctx);
+    return get_wall_time() - start;
+}
+
+// Median, min/max, dan CI median dari sampel (diurutkan di tempat). k = order
+// statistic terbesar dengan 2 * P(Binom(n, 1/2) <= k-1) <= 5%; untuk n <= 5 tidak
+// ada k seperti itu, dipakai [min, max] dengan cakupan sebenarnya di ci_level.
+static void timing_summarize(Timing* t, double* s, int n) {
+    qsort(s, (size_t)n, sizeof(double), compare_double);
+    t->trials = n;
+    t->min = s[0];
+    t->max = s[n - 1];
+    t->median = n % 2 ? s[n / 2] : 0.5 * (s[n / 2 - 1] + s[n / 2]);
+
+    double term = pow(0.5, n); // P(X = j), mulai j = 0
+    double cdf = term;         // P(X <= k-1) untuk k = 1
+    int k = 1;
+    while (k + 1 <= (n + 1) / 2) {
+        double next_term = term * (double)(n - k + 1) / k; // P(X = k)
+        if (2.0 * (cdf + next_term) > 0.05) break;
+        term = next_term;
+        cdf += next_term;
+        k++;
+    }
+    t->ci_low = s[k - 1];
+    t->ci_high = s[n - k];
+    t->ci_level = 1.0 - 2.0 * cdf;
+}
+
+// Ukur fn(ctx): auto-batching repetisi lalu TIMING_MIN_TRIALS..timing_max_trials
+// sampel dalam TIMING_BUDGET. Run tunggal yang sudah melebihi budget = 1 sampel.
+Timing timing_measure(void (*fn)(void*), void* ctx) {
+    Timing t;
+    double samples[TIMING_TRIALS_LIMIT];
+    long reps = 1;
+    double elapsed = timing_run(fn, ctx, reps);
+    t.calls = reps;
+    while (elapsed < timing_min_sample) {
+        // Perkiraan repetisi yang cukup (+25%), minimal dua kali lipat
+        long next = elapsed > 0.0 ? (long)(reps * 1.25 * timing_min_sample / elapsed) : reps * 16;
+        reps = next > 2 * reps ? next : 2 * reps;
+        elapsed = timing_run(fn, ctx, reps);
+        t.calls += reps;
+    }
+
+    int n = 0;
+    double total = elapsed;
+    samples[n++] = elapsed / reps;
+    int min_trials = timing_max_trials < TIMING_MIN_TRIALS ? timing_max_trials : TIMING_MIN_TRIALS;
+    while (n < timing_max_trials && elapsed < TIMING_BUDGET &&
+           !(n >= min_trials && total >= TIMING_BUDGET)) {
+        double e = timing_run(fn, ctx, reps);
+        t.calls += reps;
+        total += e;
+        samples[n++] = e / reps;
+    }
+    t.repetitions = reps;
+    timing_summarize(&t, samples, n);
+    return t;
+}
+
+// Field waktu satu entry JSON (indentasi 4, diakhiri koma)
+void print_timing(const Timing* t) {
+    printf("    \"time\": %.9f,\n", t->median);
+    printf("    \"time_min\": %.9f,\n", t->min);
+    printf("    \"time_max\": %.9f,\n", t->max);
+    printf("    \"time_ci\": [%.9f, %.9f],\n", t->ci_low, t->ci_high);
+    printf("    \"ci_level\": %.4f,\n", t->ci_level);
+    printf("    \"repetitions\": %ld,\n", t->repetitions);
+    printf("    \"trials\": %d,\n", t->trials);
+}
+
+// Entry "timer": sumber jam dan parameter pengukuran
+void print_timer_info(void) {
+    printf(",\n");
+    printf("  \"timer\": {\n");
+    printf("    \"source\": \"%s\",\n", timer_use_tsc ? "tsc" : TIMING_CLOCK_NAME);
+    printf("    \"resolution\": %.3e,\n", timer_resolution());
+    printf("    \"min_sample\": %.3e,\n", timing_min_sample);
+    printf("    \"max_trials\": %d,\n", timing_max_trials);
+    printf("    \"budget\": %.3f,\n", TIMING_BUDGET);
+    printf("    \"statistic\": \"median\"\n");
     printf("  }");
-    
+}
+
+// Konteks varian rekursif: n volatile agar setiap repetisi benar-benar menghitung
+// ulang (compiler tidak boleh memakai ulang hasil panggilan sebelumnya). cutoff
+// dipakai varian OpenMP dan work-stealing.
+typedef struct {
+    volatile int n;
+    volatile int result;
+    int cutoff;
+} FibTimed;
+
+static void timed_sequential(void* p) {
+    FibTimed* c = p;
+    c->result = fib_sequential(c->n);
+}
+
 #ifdef USE_OPENMP
+static void timed_openmp(void* p) {
+    FibTimed* c = p;
+    c->result = fibonacci_openmp_parallel(c->n, c->cutoff);
+}
+#endif
+
+#ifdef USE_CILK
+static void timed_cilk(void* p) {
+    FibTimed* c = p;
+    c->result = fibonacci_cilk_parallel(c->n);
+}
+#endif
+
+static void timed_worksteal(void* p) {
+    FibTimed* c = p;
+    c->result = fibonacci_worksteal_parallel(c->n, c->cutoff);
+}
+
+// ==================== Autotuning Cutoff ====================
+// Cutoff task dipilih dari dua ukuran yang diukur di mesin ini:
+//   - biaya leaf sekuensial: t_seq(k) ~ leaf_c * phi^k
+//   - overhead satu task (spawn + sync), diukur dari pohon task kosong
+// Cutoff overhead = k terkecil dengan t_seq(k) >= CUTOFF_OVERHEAD_RATIO * overhead
+// (overhead <= ~5% per leaf). Cutoff paralelisme = n - log_phi(leaf minimal),
+// agar tiap thread tetap mendapat cukup task. Dipakai yang lebih kecil.
+// Hasil ukur disimpan per (backend, threads, cpu) di profil teks.
+#define CUTOFF_PROFILE_DEFAULT "fib_cutoff_profile.txt"
+#define CUTOFF_OVERHEAD_RATIO 20.0
+#define CUTOFF_LEAVES_PER_THREAD 16
+#define CUTOFF_MIN 2
+#define CUTOFF_MAX 40
+#define CALIB_TREE_DEPTH 14 // 2^14 - 1 task kosong
+#define CALIB_LEAF_N 24
+#define CALIB_MIN_TIME 5e-3
+#define GOLDEN_RATIO 1.6180339887498949
+
+typedef struct {
+    const char* backend;   // "openmp" / "cilk" / "worksteal"
+    int threads;
+    long cpus;
+    double spawn_overhead; // detik per task
+    double leaf_c;         // t_seq(k) ~ leaf_c * phi^k
+    const char* source;    // "fixed" / "manual" / "profile" / "calibrated"
+    int overhead_cutoff;
+    int parallel_cutoff;
+    int cutoff;
+} CutoffTuning;
+
+// Waktu fib_sequential(CALIB_LEAF_N) per panggilan; input volatile agar
+// compiler tidak memakai ulang hasil panggilan sebelumnya
+double measure_leaf_c(void) {
+    volatile int k = CALIB_LEAF_N;
+    volatile int sink = 0;
+    long reps = 0;
+    double start = get_wall_time(), elapsed;
+    do {
+        sink += fib_sequential(k);
+        reps++;
+        elapsed = get_wall_time() - start;
+    } while (elapsed < CALIB_MIN_TIME);
+    (void)sink;
+    return elapsed / reps / pow(GOLDEN_RATIO, CALIB_LEAF_N);
+}
+
+// Cutoff dari hasil ukur untuk n dan jumlah thread tertentu
+void cutoff_choose(CutoffTuning* t, int n) {
+    double ratio = CUTOFF_OVERHEAD_RATIO * t->spawn_overhead / t->leaf_c;
+    int k_over = ratio > 1.0 ? (int)ceil(log(ratio) / log(GOLDEN_RATIO)) : CUTOFF_MIN;
+    int k_par = n - (int)ceil(log((double)CUTOFF_LEAVES_PER_THREAD * t->threads) / log(GOLDEN_RATIO));
+    if (k_over < CUTOFF_MIN) k_over = CUTOFF_MIN;
+    if (k_over > CUTOFF_MAX) k_over = CUTOFF_MAX;
+    if (k_par < CUTOFF_MIN) k_par = CUTOFF_MIN;
+    t->overhead_cutoff = k_over;
+    t->parallel_cutoff = k_par;
+    t->cutoff = k_over < k_par ? k_over : k_par;
+}
+
+// Cari baris "backend threads cpus spawn_overhead leaf_c" yang cocok di profil
+int cutoff_profile_load(const char* path, CutoffTuning* t) {
+    FILE* f = fopen(path, "r");
+    if (!f) return 0;
+    char backend[16];
+    int threads;
+    long cpus;
+    double overhead, leaf_c;
+    int found = 0;
+    while (fscanf(f, "%15s %d %ld %lf %lf", backend, &threads, &cpus, &overhead, &leaf_c) == 5) {
+        if (strcmp(backend, t->backend) == 0 && threads == t->threads && cpus == t->cpus &&
+            overhead > 0 && leaf_c > 0) {
+            t->spawn_overhead = overhead;
+            t->leaf_c = leaf_c;
+            found = 1;
+        }
+    }
+    fclose(f);
+    return found;
+}
+
+// Tulis ulang profil: baris lain dipertahankan, baris kunci yang sama diganti
+void cutoff_profile_save(const char* path, const CutoffTuning* t) {
+    char lines[64][128];
+    int n_lines = 0;
+    FILE* f = fopen(path, "r");
+    if (f) {
+        char line[128], backend[16];
+        int threads;
+        long cpus;
+        while (n_lines < 63 && fgets(line, sizeof(line), f)) {
+            if (sscanf(line, "%15s %d %ld", backend, &threads, &cpus) == 3 &&
+                strcmp(backend, t->backend) == 0 && threads == t->threads && cpus == t->cpus) {
+                continue;
+            }
+            snprintf(lines[n_lines++], sizeof(lines[0]), "%s", line);
+        }
+        fclose(f);
+    }
+    f = fopen(path, "w");
+    if (!f) return;
+    for (int i = 0; i < n_lines; i++) fputs(lines[i], f);
+    fprintf(f, "%s %d %ld %.6e %.6e\n", t->backend, t->threads, t->cpus,
+            t->spawn_overhead, t->leaf_c);
+    fclose(f);
+}
+
+// Ambil dari profil, atau kalibrasi (measure_overhead) lalu simpan
+void cutoff_autotune(CutoffTuning* t, int n, const char* profile, int recalibrate,
+                     double (*measure_overhead)(void)) {
+    t->cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (!recalibrate && cutoff_profile_load(profile, t)) {
+        t->source = "profile";
+    } else {
+        t->leaf_c = measure_leaf_c();
+        t->spawn_overhead = measure_overhead();
+        t->source = "calibrated";
+        cutoff_profile_save(profile, t);
+    }
+    cutoff_choose(t, n);
+}
+
+void print_cutoff_tuning(const char* key, const CutoffTuning* t, const char* profile) {
     printf(",\n");
-    printf("  \"num_threads\": %d,\n", num_threads);
-    
-    start = get_wall_time();
-    result = fibonacci_openmp_serial(N);
-    end = get_wall_time();
-    time_taken = normalize_time(end - start);
-    
-    start = get_wall_time();
-    result = fibonacci_openmp_parallel(N);
-    end = get_wall_time();
-    time_taken = normalize_time(end - start);
-    
-    speedup_omp = safe_ratio(baseline_time, time_taken);
-    efficiency_omp = (speedup_omp / num_threads) * 100;
-    
-    printf("  \"openmp_parallel\": {\n");
-    printf("    \"name\": \"OpenMP Parallel\",\n");
-    printf("    \"result\": %d,\n", result);
-    printf("    \"time\": %.6f,\n", time_taken);
-    printf("    \"speedup\": %.2f,\n", speedup_omp);
-    printf("    \"efficiency\": %.2f,\n", efficiency_omp);
-    printf("    \"cutoff\": %d,\n", CUTOFF);
-    printf("    \"model\": \"Fork-Join with Task Dependency\"\n");
+    printf("  \"%s\": {\n", key);
+    printf("    \"source\": \"%s\",\n", t->source);
+    printf("    \"threads\": %d,\n", t->threads);
+    if (t->spawn_overhead > 0) {
+        printf("    \"profile\": \"%s\",\n", profile);
+        printf("    \"cpus\": %ld,\n", t->cpus);
+        printf("    \"spawn_overhead\": %.9f,\n", t->spawn_overhead);
+        printf("    \"leaf_cost_fib%d\": %.9f,\n", CALIB_LEAF_N,
+               t->leaf_c * pow(GOLDEN_RATIO, CALIB_LEAF_N));
+        printf("    \"overhead_cutoff\": %d,\n", t->overhead_cutoff);
+        printf("    \"parallel_cutoff\": %d,\n", t->parallel_cutoff);
+    }
+    printf("    \"cutoff\": %d\n", t->cutoff);
     printf("  }");
+}
+
+#ifdef USE_OPENMP
+static void omp_task_tree(int depth) {
+    if (depth == 0) return;
+    #pragma omp task
+    omp_task_tree(depth - 1);
+    omp_task_tree(depth - 1);
+    #pragma omp taskwait
+}
+
+// Overhead per task OpenMP: pohon biner task kosong di tim penuh
+double measure_omp_spawn_overhead(void) {
+    long tasks = 0;
+    double start = get_wall_time(), elapsed;
+    do {
+        #pragma omp parallel
+        {
+            #pragma omp single
+            omp_task_tree(CALIB_TREE_DEPTH);
+        }
+        tasks += (1L << CALIB_TREE_DEPTH) - 1;
+        elapsed = get_wall_time() - start;
+    } while (elapsed < CALIB_MIN_TIME);
+    return elapsed / tasks;
+}
 #endif
 
 #ifdef USE_CILK
+static void cilk_task_tree(int depth) {
+    if (depth == 0) return;
+    cilk_spawn cilk_task_tree(depth - 1);
+    cilk_task_tree(depth - 1);
+    cilk_sync;
+}
+
+double measure_cilk_spawn_overhead(void) {
+    long tasks = 0;
+    double start = get_wall_time(), elapsed;
+    do {
+        cilk_task_tree(CALIB_TREE_DEPTH);
+        tasks += (1L << CALIB_TREE_DEPTH) - 1;
+        elapsed = get_wall_time() - start;
+    } while (elapsed < CALIB_MIN_TIME);
+    return elapsed / tasks;
+}
+#endif
+
+static void ws_task_tree_entry(void* arg);
+
+static void ws_task_tree(int depth) {
+    if (depth == 0) return;
+    int child_depth = depth - 1;
+    WsTask t;
+    t.fn = ws_task_tree_entry;
+    t.arg = &child_depth;
+    ws_spawn(&t);
+    ws_task_tree(depth - 1);
+    ws_sync(&t);
+}
+
+static void ws_task_tree_entry(void* arg) {
+    ws_task_tree(*(int*)arg);
+}
+
+// Overhead per task runtime work-stealing (pool harus sudah di-ws_init)
+double measure_ws_spawn_overhead(void) {
+    long tasks = 0;
+    int depth = CALIB_TREE_DEPTH;
+    double start = get_wall_time(), elapsed;
+    do {
+        ws_run(ws_task_tree_entry, &depth);
+        tasks += (1L << CALIB_TREE_DEPTH) - 1;
+        elapsed = get_wall_time() - start;
+    } while (elapsed < CALIB_MIN_TIME);
+    ws_reset_stats();
+    return elapsed / tasks;
+}
+
+typedef struct {
+    volatile uint64_t n;
+    volatile uint64_t m;
+    volatile uint64_t sink;
+} FastTimed;
+
+static void timed_fast_u64(void* p) {
+    FastTimed* c = p;
+    c->sink ^= fib_fast_doubling_u64(c->n);
+}
+
+static void timed_fast_u128(void* p) {
+    FastTimed* c = p;
+    c->sink ^= (uint64_t)fib_fast_doubling_u128(c->n);
+}
+
+static void timed_fast_mod(void* p) {
+    FastTimed* c = p;
+    c->sink ^= fib_fast_doubling_mod(c->n, c->m);
+}
+
+// Cetak entry "fast_doubling" (u64 sampai F(93), u128 sampai F(186))
+void print_fast_doubling(uint64_t n, int have_baseline, double baseline_time) {
+    char digits[48];
+    int bits = n <= FIB_U64_MAX_N ? 64 : 128;
+    FastTimed ctx = { n, 0, 0 };
+    Timing t = timing_measure(bits == 64 ? timed_fast_u64 : timed_fast_u128, &ctx);
+
+    if (bits == 64) {
+        snprintf(digits, sizeof(digits), "%llu", (unsigned long long)fib_fast_doubling_u64(n));
+    } else {
+        uint128_to_string(fib_fast_doubling_u128(n), digits);
+    }
+
     printf(",\n");
-    printf("  \"cilk_available\": true,\n");
-    
-    start = get_wall_time();
-    result = fibonacci_cilk_parallel(N);
-    end = get_wall_time();
-    time_taken = normalize_time(end - start);
-    if (time_taken < 1e-6) {
-        time_taken = baseline_time;
+    printf("  \"fast_doubling\": {\n");
+    printf("    \"name\": \"Fast Doubling\",\n");
+    printf("    \"result\": \"%s\",\n", digits);
+    printf("    \"bits\": %d,\n", bits);
+    print_timing(&t);
+    if (have_baseline) {
+        printf("    \"speedup\": %.2f,\n", baseline_time / t.median);
     }
-    
-    speedup_cilk = safe_ratio(baseline_time, time_taken);
-    
-    printf("  \"cilk_parallel\": {\n");
-    printf("    \"name\": \"Cilk Parallel\",\n");
+    printf("    \"model\": \"O(log n) Fast Doubling\"\n");
+    printf("  }");
+}
+
+// Cetak entry "fast_doubling_mod": F(n) mod m untuk n berapa pun
+void print_fast_doubling_mod(uint64_t n, uint64_t m) {
+    FastTimed ctx = { n, m, 0 };
+    Timing t = timing_measure(timed_fast_mod, &ctx);
+
+    printf(",\n");
+    printf("  \"fast_doubling_mod\": {\n");
+    printf("    \"name\": \"Fast Doubling mod m\",\n");
+    printf("    \"modulus\": \"%llu\",\n", (unsigned long long)m);
+    printf("    \"result\": \"%llu\",\n", (unsigned long long)fib_fast_doubling_mod(n, m));
+    print_timing(&t);
+    printf("    \"model\": \"O(log n) Fast Doubling (modular)\"\n");
+    printf("  }");
+}
+
+typedef struct {
+    volatile uint64_t n;
+    BigInt r; // hasil panggilan terakhir
+} BigTimed;
+
+static void timed_bigint(void* p) {
+    BigTimed* c = p;
+    big_free(&c->r);
+    c->r = fibonacci_bigint(c->n);
+}
+
+// Cetak entry "bigint": F(n) eksak presisi sembarang. full = sertakan semua digit
+// di "result"; selain itu hanya jumlah digit + digit awal/akhir.
+void print_bigint(uint64_t n, int full, int have_baseline, double baseline_time) {
+    BigTimed ctx = { n, { NULL, 0 } };
+    Timing t = timing_measure(timed_bigint, &ctx);
+    BigInt r = ctx.r;
+    if (!r.d) {
+        printf(",\n");
+        printf("  \"bigint\": {\n");
+        printf("    \"name\": \"Fast Doubling (BigInt)\",\n");
+        printf("    \"error\": \"Out of memory (bigint)\"\n");
+        printf("  }");
+        return;
+    }
+
+    char leading[BIG_SUMMARY_DIGITS + 1], trailing[BIG_SUMMARY_DIGITS + 1];
+    big_edge_digits(&r, leading, trailing, BIG_SUMMARY_DIGITS);
+
+    printf(",\n");
+    printf("  \"bigint\": {\n");
+    printf("    \"name\": \"Fast Doubling (BigInt)\",\n");
+    printf("    \"digits\": %zu,\n", big_digit_count(&r));
+    printf("    \"leading\": \"%s\",\n", leading);
+    printf("    \"trailing\": \"%s\",\n", trailing);
+    if (full) {
+        double format_start = get_wall_time();
+        char* text = big_to_string(&r);
+        double format_time = get_wall_time() - format_start;
+        printf("    \"result\": \"%s\",\n", text ? text : "");
+        printf("    \"format_time\": %.9f,\n", format_time);
+        free(text);
+    }
+    print_timing(&t);
+    if (have_baseline) {
+        printf("    \"speedup\": %.2f,\n", baseline_time / t.median);
+    }
+#ifdef USE_OPENMP
+    printf("    \"num_threads\": %d,\n", omp_get_max_threads());
+#endif
+    printf("    \"karatsuba_cutoff\": %d,\n", KARATSUBA_CUTOFF);
+    printf("    \"ntt_cutoff\": %d,\n", NTT_CUTOFF);
+    printf("    \"model\": \"Fast Doubling + Schoolbook/Karatsuba/NTT, OpenMP tasks\"\n");
+    printf("  }");
+    big_free(&r);
+}
+
+// Cetak entry "worksteal_parallel"; statistik steal/idle dikumpulkan selama
+// pengukuran lalu dirata-rata per run (t->calls)
+void print_worksteal(int result, int cutoff, const Timing* t, double baseline_time) {
+    long steals = 0, attempts = 0, tasks = 0;
+    double idle = 0.0;
+    double runs = (double)t->calls;
+    int workers = ws_pool.num_workers;
+    for (int i = 0; i < workers; i++) {
+        steals += ws_pool.workers[i].steals;
+        attempts += ws_pool.workers[i].steal_attempts;
+        tasks += ws_pool.workers[i].tasks;
+        idle += ws_pool.workers[i].idle_time;
+    }
+    double speedup = baseline_time / t->median;
+
+    printf(",\n");
+    printf("  \"worksteal_parallel\": {\n");
+    printf("    \"name\": \"Work-Stealing (pthreads)\",\n");
     printf("    \"result\": %d,\n", result);
-    printf("    \"time\": %.6f,\n", time_taken);
-    printf("    \"speedup\": %.2f,\n", speedup_cilk);
-    printf("    \"cutoff\": %d,\n", CILK_CUTOFF);
-    printf("    \"model\": \"Work-Stealing Scheduler\"\n");
-    printf("  }\n");
-#else
+    print_timing(t);
+    printf("    \"speedup\": %.2f,\n", speedup);
+    printf("    \"efficiency\": %.2f,\n", speedup / workers * 100);
+    printf("    \"cutoff\": %d,\n", cutoff);
+    printf("    \"workers\": %d,\n", workers);
+    printf("    \"runs\": %ld,\n", t->calls);
+    printf("    \"tasks\": %.0f,\n", tasks / runs);
+    printf("    \"steals\": %.2f,\n", steals / runs);
+    printf("    \"steal_attempts\": %.2f,\n", attempts / runs);
+    printf("    \"idle_time\": %.9f,\n", idle / runs);
+    printf("    \"per_worker\": [");
+    for (int i = 0; i < workers; i++) {
+        const WsWorker* w = &ws_pool.workers[i];
+        printf("%s\n      { \"tasks\": %.2f, \"steals\": %.2f, \"steal_attempts\": %.2f, "
+               "\"idle_time\": %.9f }",
+               i ? "," : "", w->tasks / runs, w->steals / runs, w->steal_attempts / runs,
+               w->idle_time / runs);
+    }
+    printf("\n    ],\n");
+    printf("    \"model\": \"Chase-Lev Work-Stealing (pthreads)\"\n");
+    printf("  }");
+}
+
+// Parse bilangan desimal tak bertanda 64-bit; return 0 jika tidak valid
+int parse_u64(const char* text, uint64_t* out) {
+    char* end;
+    if (!text || !*text || *text == '-') return 0;
+    unsigned long long v = strtoull(text, &end, 10);
+    if (*end != '\0') return 0;
+    *out = (uint64_t)v;
+    return 1;
+}
+
+// Batas jumlah n dalam satu --ns (satu objek JSON per n)
+#define FIB_BATCH_MAX 4096
+
+// Opsi yang berlaku untuk setiap n dalam satu invocation
+typedef struct {
+    uint64_t modulus; // 0 = tanpa mode mod
+    int bigint;
+    int full_digits;
+    int autotune;
+    int recalibrate;
+    int manual_cutoff;
+    const char* profile;
+    int num_threads;
+    const char* cpus; // --cpus=LIST (NULL = mask default proses)
+} FibOptions;
+
+// Parse daftar n: item dipisah koma, tiap item "A", "A..B", atau "A..B:STEP".
+// Return jumlah n, atau -1 jika tidak valid / lebih dari max
+int parse_n_list(const char* spec, uint64_t* out, int max) {
+    char buf[256];
+    int count = 0;
+    if (!spec || !*spec || strlen(spec) >= sizeof(buf)) return -1;
+    snprintf(buf, sizeof(buf), "%s", spec);
+    for (char* item = strtok(buf, ","); item; item = strtok(NULL, ",")) {
+        uint64_t lo, hi, step = 1;
+        char* range = strstr(item, "..");
+        if (!range) {
+            if (!parse_u64(item, &lo)) return -1;
+            hi = lo;
+        } else {
+            *range = '\0';
+            char* step_text = strchr(range + 2, ':');
+            if (step_text) {
+                *step_text = '\0';
+                if (!parse_u64(step_text + 1, &step) || step == 0) return -1;
+            }
+            if (!parse_u64(item, &lo) || !parse_u64(range + 2, &hi) || hi < lo) return -1;
+        }
+        for (uint64_t v = lo;; v += step) {
+            if (count >= max) return -1;
+            out[count++] = v;
+            if (hi - v < step) break;
+        }
+    }
+    return count;
+}
+
+// Tanpa --mod/--bigint, hasil eksak hanya sampai F(186) (128-bit); return 0 + cetak
+// objek error jika n tidak bisa dijalankan dengan opsi ini
+int fib_check_n(uint64_t n, const FibOptions* o) {
+    if (o->modulus == 0 && !o->bigint && n > FIB_U128_MAX_N) {
+        printf("{ \"error\": \"n > %d needs --mod=m or --bigint (F(n) exceeds 128 bits)\" }\n",
+               FIB_U128_MAX_N);
+        return 0;
+    }
+    if (o->bigint && n > BIGINT_MAX_N) {
+        printf("{ \"error\": \"--bigint supports n <= %llu\" }\n", BIGINT_MAX_N);
+        return 0;
+    }
+    return 1;
+}
+
+// Cetak satu objek hasil untuk n (tanpa newline penutup). warmup = jalankan
+// fib_sequential(N) dulu; mode batch melakukan warm-up sekali untuk semua n.
+// Pool work-stealing harus sudah di-ws_init bila n <= RECURSIVE_MAX_N.
+void run_fib_query(uint64_t n, const FibOptions* o, int warmup) {
+    int run_recursive = n <= RECURSIVE_MAX_N;
+    int N = (int)(run_recursive ? n : 0);
+
+    Timing timing;
+    FibTimed ctx = { N, 0, 0 };
+    double baseline_time = 0.0;
+
+    printf("{\n");
+    printf("  \"n\": %llu,\n", (unsigned long long)n);
+    printf("  \"recursive_max_n\": %d", RECURSIVE_MAX_N);
+    if (o->cpus) printf(",\n  \"cpus\": \"%s\"", o->cpus);
+    print_timer_info();
+
+    if (run_recursive) {
+        // Cutoff: --cutoff=N > --autotune (profil/kalibrasi) > default compile-time
 #ifdef USE_OPENMP
+        CutoffTuning omp_tuning = { "openmp", o->num_threads, 0, 0.0, 0.0, "fixed", 0, 0, CUTOFF };
+        if (o->manual_cutoff) {
+            omp_tuning.source = "manual";
+            omp_tuning.cutoff = o->manual_cutoff;
+        } else if (o->autotune) {
+            cutoff_autotune(&omp_tuning, N, o->profile, o->recalibrate,
+                            measure_omp_spawn_overhead);
+        }
+#endif
+#ifdef USE_CILK
+        CutoffTuning cilk_tuning = { "cilk", __cilkrts_get_nworkers(), 0, 0.0, 0.0, "fixed",
+                                     0, 0, CILK_CUTOFF };
+        if (o->manual_cutoff) {
+            cilk_tuning.source = "manual";
+            cilk_tuning.cutoff = o->manual_cutoff;
+        } else if (o->autotune) {
+            cutoff_autotune(&cilk_tuning, N, o->profile, o->recalibrate,
+                            measure_cilk_spawn_overhead);
+        }
+        cilk_cutoff = cilk_tuning.cutoff;
+#endif
+        CutoffTuning ws_tuning = { "worksteal", ws_pool.num_workers, 0, 0.0, 0.0, "fixed",
+                                   0, 0, WS_CUTOFF };
+        if (o->manual_cutoff) {
+            ws_tuning.source = "manual";
+            ws_tuning.cutoff = o->manual_cutoff;
+        } else if (o->autotune) {
+            cutoff_autotune(&ws_tuning, N, o->profile, o->recalibrate,
+                            measure_ws_spawn_overhead);
+        }
+
+        if (warmup) {
+            volatile int warmup_result = fib_sequential(N);
+            (void)warmup_result;
+        }
+
+        timing = timing_measure(timed_sequential, &ctx);
+        baseline_time = timing.median;
+
+        printf(",\n");
+        printf("  \"sequential\": {\n");
+        printf("    \"name\": \"Pure Sequential\",\n");
+        printf("    \"result\": %d,\n", ctx.result);
+        print_timing(&timing);
+        printf("    \"speedup\": 1.00,\n");
+        printf("    \"efficiency\": 100.00\n");
+        printf("  }");
+
+#ifdef USE_OPENMP
+        int num_threads = o->num_threads;
+        printf(",\n");
+        printf("  \"num_threads\": %d,\n", num_threads);
+
+        ctx.cutoff = omp_tuning.cutoff;
+        timing = timing_measure(timed_openmp, &ctx);
+        double speedup_omp = baseline_time / timing.median;
+        double efficiency_omp = (speedup_omp / num_threads) * 100;
+
+        printf("  \"openmp_parallel\": {\n");
+        printf("    \"name\": \"OpenMP Parallel\",\n");
+        printf("    \"result\": %d,\n", ctx.result);
+        print_timing(&timing);
+        printf("    \"speedup\": %.2f,\n", speedup_omp);
+        printf("    \"efficiency\": %.2f,\n", efficiency_omp);
+        printf("    \"cutoff\": %d,\n", ctx.cutoff);
+        printf("    \"model\": \"Fork-Join with Task Dependency\"\n");
+        printf("  }");
+        print_cutoff_tuning("openmp_tuning", &omp_tuning, o->profile);
+#endif
+
+#ifdef USE_CILK
+        timing = timing_measure(timed_cilk, &ctx);
+        double speedup_cilk = baseline_time / timing.median;
+
+        printf(",\n");
+        printf("  \"cilk_parallel\": {\n");
+        printf("    \"name\": \"Cilk Parallel\",\n");
+        printf("    \"result\": %d,\n", ctx.result);
+        print_timing(&timing);
+        printf("    \"speedup\": %.2f,\n", speedup_cilk);
+        printf("    \"cutoff\": %d,\n", cilk_cutoff);
+        printf("    \"model\": \"Work-Stealing Scheduler\"\n");
+        printf("  }");
+        print_cutoff_tuning("cilk_tuning", &cilk_tuning, o->profile);
+#endif
+
+        // Backend work-stealing bawaan: selalu tersedia, tanpa compiler OpenCilk
+        ws_reset_stats();
+        ctx.cutoff = ws_tuning.cutoff;
+        timing = timing_measure(timed_worksteal, &ctx);
+        print_worksteal(ctx.result, ctx.cutoff, &timing, baseline_time);
+        print_cutoff_tuning("worksteal_tuning", &ws_tuning, o->profile);
+    }
+
+    // Fast doubling: eksak (64/128-bit) bila muat, plus mode mod m jika diminta
+    if (n <= FIB_U128_MAX_N) {
+        print_fast_doubling(n, run_recursive, baseline_time);
+    }
+    if (o->modulus != 0) {
+        print_fast_doubling_mod(n, o->modulus);
+    }
+    if (o->bigint) {
+        print_bigint(n, o->full_digits, run_recursive, baseline_time);
+    }
+
     printf(",\n");
-    printf("  \"cilk_available\": false\n");
+#ifdef USE_CILK
+    printf("  \"cilk_available\": true\n");
 #else
-    printf(",\n");
     printf("  \"cilk_available\": false\n");
 #endif
+    printf("}");
+}
+
+static int worker_mode = 0; // --worker: pool work-stealing dipertahankan antar request
+
+int fib_main(int argc, char *argv[]) {
+    uint64_t n = 35;
+    FibOptions opts = { 0, 0, 0, 0, 0, 0, CUTOFF_PROFILE_DEFAULT, 1, NULL };
+    int ws_threads = 0; // 0 = sama dengan budget thread
+    int threads = 0;    // --threads=N; 0 = default proses (OMP_NUM_THREADS / jumlah CPU)
+    const char* ns_spec = NULL; // --ns=...: mode batch, output array JSON
+    int use_tsc = 0;            // --timer=tsc; tanpa invariant TSC tetap memakai jam
+    // Setelan timer di-reset per invocation (mode worker memanggil fib_main berulang)
+    timing_max_trials = TIMING_MAX_TRIALS;
+    timing_min_sample = TIMING_MIN_SAMPLE;
+    timer_use_tsc = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bigint") == 0) {
+            opts.bigint = 1;
+        } else if (strcmp(argv[i], "--autotune") == 0) {
+            opts.autotune = 1;
+        } else if (strcmp(argv[i], "--recalibrate") == 0) {
+            opts.autotune = opts.recalibrate = 1;
+        } else if (strncmp(argv[i], "--profile=", 10) == 0) {
+            opts.profile = argv[i] + 10;
+        } else if (strncmp(argv[i], "--cutoff=", 9) == 0) {
+            opts.manual_cutoff = atoi(argv[i] + 9);
+            if (opts.manual_cutoff < CUTOFF_MIN) {
+                printf("{ \"error\": \"Invalid cutoff. Must be an integer >= %d\" }\n", CUTOFF_MIN);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--ws-threads=", 13) == 0) {
+            ws_threads = atoi(argv[i] + 13);
+            if (ws_threads < 1 || ws_threads > WS_MAX_WORKERS) {
+                printf("{ \"error\": \"Invalid ws-threads. Must be 1..%d\" }\n", WS_MAX_WORKERS);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            threads = atoi(argv[i] + 10);
+            if (threads < 1 || threads > WS_MAX_WORKERS) {
+                printf("{ \"error\": \"Invalid threads. Must be 1..%d\" }\n", WS_MAX_WORKERS);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--cpus=", 7) == 0) {
+            opts.cpus = argv[i] + 7;
+            if (strlen(opts.cpus) >= CPU_LIST_MAX || strspn(opts.cpus, "0123456789,-") != strlen(opts.cpus)) {
+                printf("{ \"error\": \"Invalid cpus. Use a list like 0-3,6\" }\n");
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--trials=", 9) == 0) {
+            timing_max_trials = atoi(argv[i] + 9);
+            if (timing_max_trials < 1 || timing_max_trials > TIMING_TRIALS_LIMIT) {
+                printf("{ \"error\": \"Invalid trials. Must be 1..%d\" }\n", TIMING_TRIALS_LIMIT);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--min-sample=", 13) == 0) {
+            timing_min_sample = atof(argv[i] + 13);
+            if (!(timing_min_sample >= 0.0 && timing_min_sample <= 1.0)) {
+                printf("{ \"error\": \"Invalid min-sample. Must be 0..1 seconds\" }\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--timer=tsc") == 0) {
+            use_tsc = 1;
+        } else if (strcmp(argv[i], "--timer=clock") == 0) {
+            use_tsc = 0;
+        } else if (strncmp(argv[i], "--ns=", 5) == 0) {
+            ns_spec = argv[i] + 5;
+        } else if (strcmp(argv[i], "--digits=full") == 0) {
+            opts.full_digits = 1;
+        } else if (strcmp(argv[i], "--digits=summary") == 0) {
+            opts.full_digits = 0;
+        } else if (strncmp(argv[i], "--mod=", 6) == 0) {
+            if (!parse_u64(argv[i] + 6, &opts.modulus) || opts.modulus == 0) {
+                printf("{ \"error\": \"Invalid modulus. Must be an integer >= 1\" }\n");
+                return 1;
+            }
+        } else if (!parse_u64(argv[i], &n)) {
+            printf("{ \"error\": \"Invalid n. Must be a non-negative integer\" }\n");
+            return 1;
+        }
+    }
+
+    static uint64_t ns[FIB_BATCH_MAX];
+    int count = 1;
+    ns[0] = n;
+    if (ns_spec) {
+        count = parse_n_list(ns_spec, ns, FIB_BATCH_MAX);
+        if (count < 0) {
+            printf("{ \"error\": \"Invalid --ns. Use A,B,C or A..B[:STEP] (max %d values)\" }\n",
+                   FIB_BATCH_MAX);
+            return 1;
+        }
+    }
+    int max_recursive = -1; // N rekursif terbesar; -1 = tidak ada
+    for (int i = 0; i < count; i++) {
+        if (!fib_check_n(ns[i], &opts)) return 1;
+        if (ns[i] <= RECURSIVE_MAX_N && (int)ns[i] > max_recursive) max_recursive = (int)ns[i];
+    }
+
+    if (use_tsc) timer_enable_tsc();
+    // Budget thread/core dari server (--threads / --cpus), atau default proses
+    int budget = cpu_budget_apply(threads, opts.cpus);
+    if (budget < 0) {
+        printf("{ \"error\": \"Invalid cpus. No usable CPU in list\" }\n");
+        return 1;
+    }
+#ifdef USE_OPENMP
+    opts.num_threads = budget;
 #endif
+    if (ws_threads == 0) ws_threads = budget < WS_MAX_WORKERS ? budget : WS_MAX_WORKERS;
 
-    printf("}\n");
-    
+    // Thread pool dibuat sekali untuk semua n: worker work-stealing di sini, tim
+    // OpenMP dipakai ulang oleh runtime antar parallel region
+    if (max_recursive >= 0 && ws_ensure(ws_threads) != 0) {
+        printf("{ \"error\": \"Failed to start work-stealing workers\" }\n");
+        return 1;
+    }
+
+    // Batch: satu warm-up bersama (n rekursif terbesar + pembuatan tim OpenMP),
+    // lalu semua n diukur berurutan
+    int shared_warmup = ns_spec != NULL;
+    if (shared_warmup && max_recursive >= 0) {
+        volatile int warmup_result = fib_sequential(max_recursive);
+        (void)warmup_result;
+#ifdef USE_OPENMP
+        #pragma omp parallel
+        {
+            (void)0;
+        }
+#endif
+    }
+
+    if (ns_spec) printf("[\n");
+    for (int i = 0; i < count; i++) {
+        run_fib_query(ns[i], &opts, !shared_warmup);
+        printf(ns_spec && i + 1 < count ? ",\n" : "\n");
+        // Kalibrasi ulang cukup sekali; n berikutnya memakai profil yang baru disimpan
+        if (ns[i] <= RECURSIVE_MAX_N) opts.recalibrate = 0;
+    }
+    if (ns_spec) printf("]\n");
+
+    if (max_recursive >= 0 && !worker_mode) ws_shutdown();
+    return 0;
+}
+
+// Build library (-DFIB_LIBRARY, addon Node di native/): tanpa worker mode dan main
+#ifndef FIB_LIBRARY
+
+// ==================== Worker Mode (--worker) ====================
+// Proses berumur panjang untuk server: satu request JSON per baris di stdin,
+//   {"id": 7, "args": ["35", "--mod=97"]}   atau   {"id": 8, "op": "ping"}
+// Argumen dijalankan persis seperti invocation CLI (fib_main) dengan stdout
+// ditangkap ke memori; pool work-stealing dan tim OpenMP tetap hidup antar request.
+// Satu baris respons per request di stdout:
+//   {"id": 7, "exit": 0, "result": <output JSON>}   /   {"id": 8, "pong": true}
+#define WORKER_MAX_ARGS 32
+#define WORKER_ID_MAX 64
+
+static const char* json_skip_ws(const char* p) {
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+    return p;
+}
+
+// String JSON di p (dimulai '"') ke out (escape dasar + \uXXXX ASCII); return
+// posisi setelah '"' penutup atau NULL
+static const char* json_parse_string(const char* p, char* out, size_t cap) {
+    size_t len = 0;
+    if (*p++ != '"') return NULL;
+    while (*p && *p != '"') {
+        char c = *p++;
+        if (c == '\\') {
+            c = *p++;
+            switch (c) {
+            case 'n': c = '\n'; break;
+            case 't': c = '\t'; break;
+            case 'r': c = '\r'; break;
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'u': {
+                unsigned v;
+                if (sscanf(p, "%4x", &v) != 1 || v > 0x7F) return NULL;
+                c = (char)v;
+                p += 4;
+                break;
+            }
+            case '"': case '\\': case '/': break;
+            default: return NULL;
+            }
+        }
+        if (len + 1 >= cap) return NULL;
+        out[len++] = c;
+    }
+    if (*p != '"') return NULL;
+    out[len] = '\0';
+    return p + 1;
+}
+
+// Parse request satu baris (objek datar: "id" angka/string, "op" string, "args"
+// array string). String args disimpan berurutan di storage. Return argc atau -1
+static int worker_parse_request(const char* line, char* id, char* op, char* storage,
+                                size_t cap, char** args, int max_args) {
+    char key[32];
+    int argc = 0;
+    size_t used = 0;
+    const char* p = json_skip_ws(line);
+    strcpy(id, "null");
+    op[0] = '\0';
+    if (*p++ != '{') return -1;
+    for (;;) {
+        p = json_skip_ws(p);
+        if (*p == '}') break;
+        if (!(p = json_parse_string(p, key, sizeof(key)))) return -1;
+        p = json_skip_ws(p);
+        if (*p++ != ':') return -1;
+        p = json_skip_ws(p);
+        if (strcmp(key, "args") == 0) {
+            if (*p++ != '[') return -1;
+            p = json_skip_ws(p);
+            while (*p != ']') {
+                if (argc >= max_args) return -1;
+                args[argc] = storage + used;
+                if (!(p = json_parse_string(p, storage + used, cap - used))) return -1;
+                used += strlen(args[argc++]) + 1;
+                p = json_skip_ws(p);
+                if (*p == ',') p = json_skip_ws(p + 1);
+                else if (*p != ']') return -1;
+            }
+            p++;
+        } else if (*p == '"') {
+            char value[WORKER_ID_MAX];
+            const char* start = p;
+            if (!(p = json_parse_string(p, value, sizeof(value)))) return -1;
+            if (strcmp(key, "op") == 0) {
+                snprintf(op, WORKER_ID_MAX, "%s", value);
+            } else if (strcmp(key, "id") == 0) {
+                snprintf(id, WORKER_ID_MAX, "%.*s", (int)(p - start), start);
+            }
+        } else {
+            // angka / true / false / null
+            const char* start = p;
+            while (*p && *p != ',' && *p != '}' && *p != ' ') p++;
+            if (p == start || (size_t)(p - start) >= WORKER_ID_MAX) return -1;
+            if (strcmp(key, "id") == 0) snprintf(id, WORKER_ID_MAX, "%.*s", (int)(p - start), start);
+        }
+        p = json_skip_ws(p);
+        if (*p == ',') p++;
+        else if (*p != '}') return -1;
+    }
+    return argc;
+}
+
+int run_worker(void) {
+    char* line = NULL;
+    size_t line_cap = 0;
+    worker_mode = 1;
+    while (getline(&line, &line_cap, stdin) > 0) {
+        char id[WORKER_ID_MAX], op[WORKER_ID_MAX], storage[4096];
+        char* args[WORKER_MAX_ARGS + 1];
+        int argc = worker_parse_request(line, id, op, storage, sizeof(storage),
+                                        args + 1, WORKER_MAX_ARGS);
+        if (argc < 0) {
+            printf("{\"id\": %s, \"error\": \"invalid request\"}\n", id);
+        } else if (strcmp(op, "ping") == 0) {
+            printf("{\"id\": %s, \"pong\": true}\n", id);
+        } else {
+            // stdout dialihkan ke memori selama fib_main berjalan
+            char* text = NULL;
+            size_t len = 0;
+            FILE* mem = open_memstream(&text, &len);
+            int ret = 1;
+            if (mem) {
+                FILE* saved = stdout;
+                fflush(stdout);
+                stdout = mem;
+                args[0] = "fib_omp_json";
+                ret = fib_main(argc + 1, args);
+                fflush(mem);
+                stdout = saved;
+                fclose(mem);
+            }
+            // Output JSON tidak memuat newline di dalam string: aman dijadikan satu baris
+            for (size_t i = 0; i < len; i++) {
+                if (text[i] == '\n') text[i] = ' ';
+            }
+            printf("{\"id\": %s, \"exit\": %d, \"result\": %s}\n", id, ret,
+                   len > 0 ? text : "null");
+            free(text);
+        }
+        fflush(stdout);
+    }
+    free(line);
+    if (ws_pool.workers) ws_shutdown();
     return 0;
 }
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--worker") == 0) {
+        return run_worker();
+    }
+    return fib_main(argc, argv);
+}
+
+#endif // FIB_LIBRARY
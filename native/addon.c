@@ -0,0 +1,15 @@
+// Addon Node (N-API) "algokom_native": kernel Fibonacci dan bilinear dipanggil
+// langsung di proses server, tanpa spawn program C dan tanpa parsing stdout.
+// Build: npm run build:native (node-gyp, lihat binding.gyp di direktori ini).
+#include <node_api.h>
+
+napi_value fib_native_init(napi_env env, napi_value exports);
+napi_value bilinear_native_init(napi_env env, napi_value exports);
+
+static napi_value addon_init(napi_env env, napi_value exports) {
+    fib_native_init(env, exports);
+    bilinear_native_init(env, exports);
+    return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, addon_init)
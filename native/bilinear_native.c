@@ -0,0 +1,419 @@
+/*
+ * Binding N-API untuk kernel bilinear: bilinear_serial_parallel.c dikompilasi
+ * langsung di translation unit ini (tanpa worker mode dan main, lihat
+ * BILINEAR_LIBRARY). Piksel tidak pernah disalin antara JS dan C:
+ *  - input resize/encode dibaca langsung dari memori Buffer / TypedArray JS
+ *    (direferensikan selama kerja async berjalan);
+ *  - hasil decode/resize/encode adalah Buffer eksternal di atas blok buffer pool,
+ *    dikembalikan ke pool oleh finalizer saat Buffer di-GC.
+ * Semua kerja berat berjalan di thread pool libuv (napi_async_work).
+ */
+#include <node_api.h>
+#include "../bilinear_serial_parallel.c"
+
+/* Batas cache buffer pool yang menganggur di proses Node (sama dengan mode worker) */
+#define NATIVE_POOL_CACHE_MAX ((size_t)256 << 20)
+
+typedef enum {
+    BILINEAR_OP_DECODE = 0,
+    BILINEAR_OP_RESIZE,
+    BILINEAR_OP_ENCODE_PNG
+} BilinearOp;
+
+typedef struct {
+    napi_async_work work;
+    napi_deferred deferred;
+    napi_ref input_ref;      /* menahan Buffer input dari GC selama kerja async */
+    BilinearOp op;
+    /* Input */
+    const unsigned char* bytes; /* decode: isi file */
+    size_t bytes_len;
+    ImageView src;           /* resize/encode: view di atas memori JS */
+    int new_w, new_h;
+    int threads;             /* resize: <= 1 = serial; encode: 0 = default OpenMP */
+    KernelMode kernel;
+    int png_level;
+    /* Output (blok pool, diserahkan ke Buffer eksternal) */
+    Image* decoded;
+    ImageView dst;
+    unsigned char* png;
+    size_t png_len;
+    double time;
+    const char* error;
+} BilinearCall;
+
+#define BILINEAR_THROW(env, msg) \
+    do { napi_throw_type_error((env), NULL, (msg)); return NULL; } while (0)
+
+static double bilinear_native_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void bilinear_native_execute(napi_env env, void* data) {
+    BilinearCall* c = data;
+    (void)env;
+    double start = bilinear_native_now();
+    switch (c->op) {
+        case BILINEAR_OP_DECODE:
+            c->decoded = decode_image_mem(c->bytes, c->bytes_len);
+            if (!c->decoded) c->error = "Unsupported or corrupt image (PNG, PPM P5/P6, PAM P7)";
+            break;
+        case BILINEAR_OP_RESIZE:
+            if (image_view_alloc(&c->dst, c->new_w, c->new_h, c->src.channels, c->src.bit_depth) != 0) {
+                c->error = "Out of memory";
+                break;
+            }
+            start = bilinear_native_now(); /* waktu resize saja, tanpa alokasi */
+            if ((c->threads > 1
+                     ? bilinear_resize_parallel_into(&c->src, &c->dst, c->threads, c->kernel)
+                     : bilinear_resize_serial_into(&c->src, &c->dst, c->kernel)) != 0) {
+                image_view_free(&c->dst);
+                c->error = "Resize failed";
+            }
+            break;
+        case BILINEAR_OP_ENCODE_PNG: {
+            /* ICV jumlah thread milik thread libuv ini; dikembalikan setelah encode */
+            int saved_threads = omp_get_max_threads();
+            if (c->threads > 0) omp_set_num_threads(c->threads);
+            if (encode_png_mem(&c->src, c->png_level, &c->png, &c->png_len) != 0) {
+                c->error = "PNG encode failed";
+            }
+            omp_set_num_threads(saved_threads);
+            break;
+        }
+    }
+    c->time = bilinear_native_now() - start;
+}
+
+static void bilinear_native_free_image(napi_env env, void* data, void* hint) {
+    (void)env;
+    (void)data;
+    free_image_struct(hint);
+}
+
+static void bilinear_native_free_block(napi_env env, void* data, void* hint) {
+    (void)env;
+    (void)hint;
+    pool_free(data);
+}
+
+static void bilinear_native_set_int(napi_env env, napi_value obj, const char* key, int64_t v) {
+    napi_value value;
+    napi_create_int64(env, v, &value);
+    napi_set_named_property(env, obj, key, value);
+}
+
+/*
+ * Objek citra JS: { data: Buffer, width, height, channels, bitDepth, stride }.
+ * data adalah Buffer eksternal yang memiliki blok pool-nya sendiri.
+ */
+static napi_value bilinear_native_image_object(napi_env env, unsigned char* data,
+                                               const ImageView* v, napi_finalize fin,
+                                               void* hint)
+{
+    napi_value obj, buf;
+    napi_create_object(env, &obj);
+    napi_create_external_buffer(env, v->stride * v->height, data, fin, hint, &buf);
+    napi_set_named_property(env, obj, "data", buf);
+    bilinear_native_set_int(env, obj, "width", v->width);
+    bilinear_native_set_int(env, obj, "height", v->height);
+    bilinear_native_set_int(env, obj, "channels", v->channels);
+    bilinear_native_set_int(env, obj, "bitDepth", v->bit_depth);
+    bilinear_native_set_int(env, obj, "stride", (int64_t)v->stride);
+    return obj;
+}
+
+static void bilinear_native_complete(napi_env env, napi_status status, void* data) {
+    BilinearCall* c = data;
+    napi_value result = NULL, value;
+
+    if (status == napi_ok && !c->error) {
+        switch (c->op) {
+            case BILINEAR_OP_DECODE: {
+                ImageView v = image_view_of(c->decoded);
+                result = bilinear_native_image_object(env, c->decoded->data, &v,
+                                                      bilinear_native_free_image, c->decoded);
+                c->decoded = NULL;
+                break;
+            }
+            case BILINEAR_OP_RESIZE:
+                result = bilinear_native_image_object(env, c->dst.data, &c->dst,
+                                                      bilinear_native_free_block, NULL);
+                c->dst.data = NULL;
+                napi_create_string_utf8(env, kernel_mode_name(c->kernel), NAPI_AUTO_LENGTH, &value);
+                napi_set_named_property(env, result, "kernel", value);
+                bilinear_native_set_int(env, result, "threads", c->threads > 1 ? c->threads : 1);
+                break;
+            case BILINEAR_OP_ENCODE_PNG:
+                napi_create_external_buffer(env, c->png_len, c->png, bilinear_native_free_block,
+                                            NULL, &result);
+                c->png = NULL;
+                break;
+        }
+        if (c->op != BILINEAR_OP_ENCODE_PNG) {
+            napi_create_double(env, c->time, &value);
+            napi_set_named_property(env, result, "time", value);
+        }
+        napi_resolve_deferred(env, c->deferred, result);
+    } else {
+        napi_value msg, err;
+        napi_create_string_utf8(env, c->error ? c->error : "Bilinear call cancelled",
+                                NAPI_AUTO_LENGTH, &msg);
+        napi_create_error(env, NULL, msg, &err);
+        napi_reject_deferred(env, c->deferred, err);
+    }
+
+    if (c->input_ref) napi_delete_reference(env, c->input_ref);
+    napi_delete_async_work(env, c->work);
+    if (c->decoded) free_image_struct(c->decoded);
+    if (c->dst.data) image_view_free(&c->dst);
+    if (c->png) pool_free(c->png);
+    free(c);
+    pool_trim(NATIVE_POOL_CACHE_MAX);
+}
+
+/*
+ * Ambil pointer + panjang dari Buffer, TypedArray, atau ArrayBuffer (tanpa salinan)
+ */
+static int bilinear_native_bytes(napi_env env, napi_value value, void** data, size_t* len)
+{
+    bool is;
+    if (napi_is_buffer(env, value, &is) == napi_ok && is) {
+        return napi_get_buffer_info(env, value, data, len) == napi_ok ? 0 : -1;
+    }
+    if (napi_is_typedarray(env, value, &is) == napi_ok && is) {
+        napi_typedarray_type type;
+        size_t length, offset;
+        napi_value arraybuffer;
+        if (napi_get_typedarray_info(env, value, &type, &length, data, &arraybuffer,
+                                     &offset) != napi_ok) return -1;
+        switch (type) {
+            case napi_uint16_array:
+            case napi_int16_array:  *len = length * 2; break;
+            case napi_uint32_array:
+            case napi_int32_array:
+            case napi_float32_array: *len = length * 4; break;
+            case napi_float64_array:
+            case napi_bigint64_array:
+            case napi_biguint64_array: *len = length * 8; break;
+            default:                 *len = length; break;
+        }
+        return 0;
+    }
+    if (napi_is_arraybuffer(env, value, &is) == napi_ok && is) {
+        return napi_get_arraybuffer_info(env, value, data, len) == napi_ok ? 0 : -1;
+    }
+    return -1;
+}
+
+static int bilinear_native_get_int(napi_env env, napi_value obj, const char* key, int* out)
+{
+    bool has = false;
+    napi_value value;
+    double d;
+    if (napi_has_named_property(env, obj, key, &has) != napi_ok || !has) return 0;
+    napi_get_named_property(env, obj, key, &value);
+    if (napi_get_value_double(env, value, &d) != napi_ok) return -1;
+    if (d != floor(d) || d < INT_MIN || d > INT_MAX) return -1;
+    *out = (int)d;
+    return 1;
+}
+
+/*
+ * Baca objek citra JS menjadi view di atas memorinya (stride default = baris rapat).
+ * Return pesan error atau NULL.
+ */
+static const char* bilinear_native_read_image(napi_env env, napi_value obj, ImageView* v,
+                                              napi_value* data_value)
+{
+    napi_valuetype type;
+    void* data;
+    size_t len;
+    int stride = 0;
+    napi_typeof(env, obj, &type);
+    if (type != napi_object) return "image must be an object { data, width, height, channels, bitDepth }";
+    if (napi_get_named_property(env, obj, "data", data_value) != napi_ok ||
+        bilinear_native_bytes(env, *data_value, &data, &len) != 0) {
+        return "image.data must be a Buffer, TypedArray or ArrayBuffer";
+    }
+    v->channels = 3;
+    v->bit_depth = 8;
+    if (bilinear_native_get_int(env, obj, "width", &v->width) != 1 ||
+        bilinear_native_get_int(env, obj, "height", &v->height) != 1 ||
+        bilinear_native_get_int(env, obj, "channels", &v->channels) < 0 ||
+        bilinear_native_get_int(env, obj, "bitDepth", &v->bit_depth) < 0 ||
+        bilinear_native_get_int(env, obj, "stride", &stride) < 0) {
+        return "image.width/height must be integers";
+    }
+    if (v->width < 1 || v->height < 1) return "image dimensions must be >= 1";
+    if (v->channels != 1 && v->channels != 3 && v->channels != 4) return "image.channels must be 1, 3 or 4";
+    if (v->bit_depth != 8 && v->bit_depth != 16) return "image.bitDepth must be 8 or 16";
+    size_t row = (size_t)v->width * pixel_bytes(v->channels, v->bit_depth);
+    v->stride = stride > 0 ? (size_t)stride : row;
+    if (v->stride < row) return "image.stride is smaller than one row";
+    if (v->stride * (size_t)(v->height - 1) + row > len) return "image.data is smaller than width x height";
+    if (v->bit_depth == 16 && (((uintptr_t)data | v->stride) & 1)) return "16-bit image.data must be 2-byte aligned";
+    v->data = data;
+    return NULL;
+}
+
+static napi_value bilinear_native_queue(napi_env env, BilinearCall* c, napi_value input,
+                                        const char* name)
+{
+    napi_value promise, resource_name;
+    napi_create_reference(env, input, 1, &c->input_ref);
+    napi_create_promise(env, &c->deferred, &promise);
+    napi_create_string_utf8(env, name, NAPI_AUTO_LENGTH, &resource_name);
+    napi_create_async_work(env, NULL, resource_name, bilinear_native_execute,
+                           bilinear_native_complete, c, &c->work);
+    napi_queue_async_work(env, c->work);
+    return promise;
+}
+
+/*
+ * decode(bytes) -> Promise<image>: PNG / PPM / PAM dari Buffer (mis. body upload)
+ */
+static napi_value bilinear_native_decode(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    void* data;
+    size_t len;
+    napi_get_cb_info(env, info, &argc, argv, NULL, NULL);
+    if (argc < 1 || bilinear_native_bytes(env, argv[0], &data, &len) != 0) {
+        BILINEAR_THROW(env, "decode(bytes): bytes must be a Buffer, TypedArray or ArrayBuffer");
+    }
+    BilinearCall* c = calloc(1, sizeof(*c));
+    if (!c) BILINEAR_THROW(env, "Out of memory");
+    c->op = BILINEAR_OP_DECODE;
+    c->bytes = data;
+    c->bytes_len = len;
+    return bilinear_native_queue(env, c, argv[0], "algokom.bilinear.decode");
+}
+
+/*
+ * resize(image, { scale | width, height, kernel, threads }) -> Promise<image + time>
+ * width/height 0 = ikuti rasio aspek (seperti mode batch). threads <= 1 = serial.
+ */
+static napi_value bilinear_native_resize(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value argv[2], data_value;
+    napi_valuetype type = napi_undefined;
+    ImageView src;
+    napi_get_cb_info(env, info, &argc, argv, NULL, NULL);
+    if (argc < 2) BILINEAR_THROW(env, "resize(image, options): options are required");
+    const char* error = bilinear_native_read_image(env, argv[0], &src, &data_value);
+    if (error) BILINEAR_THROW(env, error);
+    napi_typeof(env, argv[1], &type);
+    if (type != napi_object) BILINEAR_THROW(env, "resize(image, options): options must be an object");
+
+    int new_w = 0, new_h = 0, threads = 1;
+    KernelMode kernel = KERNEL_DOUBLE;
+    bool has_scale = false;
+    napi_has_named_property(env, argv[1], "scale", &has_scale);
+    if (has_scale) {
+        napi_value value;
+        double scale;
+        napi_get_named_property(env, argv[1], "scale", &value);
+        if (napi_get_value_double(env, value, &scale) != napi_ok || !(scale > 0.0 && scale <= 64.0)) {
+            BILINEAR_THROW(env, "options.scale must be a number in (0, 64]");
+        }
+        resize_target_dims(src.width, src.height, scale, &new_w, &new_h);
+    } else {
+        if (bilinear_native_get_int(env, argv[1], "width", &new_w) < 0 ||
+            bilinear_native_get_int(env, argv[1], "height", &new_h) < 0 ||
+            new_w < 0 || new_h < 0 || (new_w == 0 && new_h == 0)) {
+            BILINEAR_THROW(env, "options needs scale, or width and/or height");
+        }
+        if (new_w == 0) new_w = (int)((double)src.width * new_h / src.height + 0.5);
+        if (new_h == 0) new_h = (int)((double)src.height * new_w / src.width + 0.5);
+        if (new_w < 1) new_w = 1;
+        if (new_h < 1) new_h = 1;
+    }
+    if ((double)new_w * new_h > 1e9) BILINEAR_THROW(env, "Output image too large");
+    if (bilinear_native_get_int(env, argv[1], "threads", &threads) < 0 || threads > 256) {
+        BILINEAR_THROW(env, "options.threads must be an integer <= 256");
+    }
+
+    bool has_kernel = false;
+    napi_has_named_property(env, argv[1], "kernel", &has_kernel);
+    if (has_kernel) {
+        napi_value value;
+        char name[16];
+        size_t len;
+        napi_get_named_property(env, argv[1], "kernel", &value);
+        if (napi_get_value_string_utf8(env, value, name, sizeof(name), &len) != napi_ok) {
+            BILINEAR_THROW(env, "options.kernel must be 'double', 'fixed' or 'simd'");
+        }
+        if (strcmp(name, "fixed") == 0) kernel = KERNEL_FIXED;
+        else if (strcmp(name, "simd") == 0) kernel = KERNEL_SIMD;
+        else if (strcmp(name, "double") != 0) {
+            BILINEAR_THROW(env, "options.kernel must be 'double', 'fixed' or 'simd'");
+        }
+    }
+
+    BilinearCall* c = calloc(1, sizeof(*c));
+    if (!c) BILINEAR_THROW(env, "Out of memory");
+    c->op = BILINEAR_OP_RESIZE;
+    c->src = src;
+    c->new_w = new_w;
+    c->new_h = new_h;
+    c->threads = threads;
+    c->kernel = kernel;
+    return bilinear_native_queue(env, c, data_value, "algokom.bilinear.resize");
+}
+
+/*
+ * encodePng(image, { level, threads }) -> Promise<Buffer> (deflate paralel per band;
+ * threads = budget thread OpenMP, default semua core)
+ */
+static napi_value bilinear_native_encode_png(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value argv[2], data_value;
+    napi_valuetype type = napi_undefined;
+    ImageView src;
+    int level = PNG_DEFAULT_LEVEL, threads = 0;
+    napi_get_cb_info(env, info, &argc, argv, NULL, NULL);
+    if (argc < 1) BILINEAR_THROW(env, "encodePng(image, options): image is required");
+    const char* error = bilinear_native_read_image(env, argv[0], &src, &data_value);
+    if (error) BILINEAR_THROW(env, error);
+    if (argc > 1) napi_typeof(env, argv[1], &type);
+    if (type == napi_object &&
+        (bilinear_native_get_int(env, argv[1], "level", &level) < 0 || level < 0 || level > 9)) {
+        BILINEAR_THROW(env, "options.level must be 0..9");
+    }
+    if (type == napi_object &&
+        (bilinear_native_get_int(env, argv[1], "threads", &threads) < 0 || threads < 0 ||
+         threads > 256)) {
+        BILINEAR_THROW(env, "options.threads must be an integer 1..256");
+    }
+
+    BilinearCall* c = calloc(1, sizeof(*c));
+    if (!c) BILINEAR_THROW(env, "Out of memory");
+    c->op = BILINEAR_OP_ENCODE_PNG;
+    c->src = src;
+    c->png_level = level;
+    c->threads = threads;
+    return bilinear_native_queue(env, c, data_value, "algokom.bilinear.encodePng");
+}
+
+napi_value bilinear_native_init(napi_env env, napi_value exports)
+{
+    napi_value fn, value;
+    /* ISA untuk --kernel=simd dipilih sekali per proses (seperti bilinear_main) */
+    simd_isa = detect_isa();
+
+    napi_create_function(env, "decode", NAPI_AUTO_LENGTH, bilinear_native_decode, NULL, &fn);
+    napi_set_named_property(env, exports, "decode", fn);
+    napi_create_function(env, "resize", NAPI_AUTO_LENGTH, bilinear_native_resize, NULL, &fn);
+    napi_set_named_property(env, exports, "resize", fn);
+    napi_create_function(env, "encodePng", NAPI_AUTO_LENGTH, bilinear_native_encode_png, NULL, &fn);
+    napi_set_named_property(env, exports, "encodePng", fn);
+    napi_create_string_utf8(env, isa_name(simd_isa), NAPI_AUTO_LENGTH, &value);
+    napi_set_named_property(env, exports, "simdIsa", value);
+    return exports;
+}
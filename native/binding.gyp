@@ -0,0 +1,20 @@
+{
+  "targets": [
+    {
+      "target_name": "algokom_native",
+      "sources": ["addon.c", "fib_native.c", "bilinear_native.c"],
+      "defines": ["NAPI_VERSION=8", "USE_OPENMP", "FIB_LIBRARY", "BILINEAR_LIBRARY", "_GNU_SOURCE"],
+      "cflags": ["-O3", "-fopenmp", "-std=gnu11", "-Wno-unused-function"],
+      "ldflags": ["-fopenmp", "-pthread"],
+      "libraries": ["-lz", "-lm"],
+      "conditions": [
+        ["OS=='mac'", {
+          "xcode_settings": {
+            "OTHER_CFLAGS": ["-O3", "-fopenmp", "-std=gnu11", "-Wno-unused-function"],
+            "OTHER_LDFLAGS": ["-fopenmp"]
+          }
+        }]
+      ]
+    }
+  ]
+}
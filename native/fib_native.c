@@ -0,0 +1,465 @@
+// Binding N-API untuk kernel Fibonacci: fibonacci_json.c dikompilasi langsung di
+// translation unit ini (tanpa worker mode dan main, lihat FIB_LIBRARY) sehingga
+// semua fungsi dan state static-nya bisa dipakai tanpa header terpisah.
+#include <node_api.h>
+#include "../fibonacci_json.c"
+
+// Panggilan berjalan bersamaan di thread pool libuv tanpa lock: cutoff dibawa sebagai
+// argumen kernel, setelan timing thread-local, dan ICV jumlah thread OpenMP milik
+// thread pemanggil. Satu-satunya state bersama adalah pool work-stealing, jadi mode
+// worksteal diantrekan ke satu thread khusus di luar thread pool libuv (tidak ada
+// thread libuv yang menunggu) dan hasilnya dikirim balik lewat threadsafe function.
+
+typedef enum {
+    FIB_NATIVE_SEQUENTIAL = 0,
+    FIB_NATIVE_OPENMP,
+    FIB_NATIVE_WORKSTEAL,
+    FIB_NATIVE_FAST,
+    FIB_NATIVE_MOD,
+    FIB_NATIVE_BIGINT
+} FibNativeMode;
+
+static const char* const fib_native_mode_names[] = {
+    "sequential", "openmp", "worksteal", "fast", "mod", "bigint"
+};
+
+typedef struct FibNativeCall {
+    napi_async_work work;            // mode selain worksteal
+    napi_threadsafe_function done;   // mode worksteal
+    struct FibNativeCall* next;      // antrean thread work-stealing
+    napi_deferred deferred;
+    // Input (dibaca di thread utama)
+    uint64_t n;
+    uint64_t modulus;
+    FibNativeMode mode;
+    int cutoff;      // 0 = default compile-time
+    int threads;     // 0 = default (OpenMP / jumlah CPU)
+    int trials;      // 0 = TIMING_MAX_TRIALS
+    double min_sample;
+    // Output (ditulis di thread pool)
+    Timing timing;
+    uint128_t value; // hasil eksak selain bigint
+    char* digits;    // hasil bigint (desimal, malloc)
+    int used_cutoff;
+    int used_threads;
+    const char* error;
+} FibNativeCall;
+
+#define FIB_NATIVE_THROW(env, msg) \
+    do { napi_throw_type_error((env), NULL, (msg)); return NULL; } while (0)
+
+// Antrean FIFO untuk thread work-stealing; thread dibuat saat panggilan pertama
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    FibNativeCall* head;
+    FibNativeCall* tail;
+    int started;
+} fib_native_ws = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, NULL, 0 };
+
+// Hitung satu panggilan di thread pemanggil (thread libuv atau thread work-stealing)
+static void fib_native_run(FibNativeCall* c) {
+    timing_max_trials = c->trials > 0 ? c->trials : TIMING_MAX_TRIALS;
+    timing_min_sample = c->min_sample >= 0.0 ? c->min_sample : TIMING_MIN_SAMPLE;
+
+    switch (c->mode) {
+        case FIB_NATIVE_SEQUENTIAL: {
+            FibTimed ctx = { (int)c->n, 0, 0 };
+            c->timing = timing_measure(timed_sequential, &ctx);
+            c->value = (uint128_t)ctx.result;
+            break;
+        }
+#ifdef USE_OPENMP
+        case FIB_NATIVE_OPENMP: {
+            FibTimed ctx = { (int)c->n, 0, c->cutoff ? c->cutoff : CUTOFF };
+            // ICV jumlah thread milik thread libuv ini; dikembalikan setelah ukur
+            int saved_threads = omp_get_max_threads();
+            if (c->threads) omp_set_num_threads(c->threads);
+            c->timing = timing_measure(timed_openmp, &ctx);
+            c->value = (uint128_t)ctx.result;
+            c->used_cutoff = ctx.cutoff;
+            c->used_threads = omp_get_max_threads();
+            omp_set_num_threads(saved_threads);
+            break;
+        }
+#endif
+        case FIB_NATIVE_WORKSTEAL: {
+            FibTimed ctx = { (int)c->n, 0, c->cutoff ? c->cutoff : WS_CUTOFF };
+            int workers = c->threads;
+            if (workers == 0) {
+                long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+                workers = cpus > 0 ? (int)(cpus < WS_MAX_WORKERS ? cpus : WS_MAX_WORKERS) : 1;
+            }
+            // Pool dibiarkan hidup untuk panggilan berikutnya (seperti mode worker)
+            if (ws_ensure(workers) != 0) {
+                c->error = "Failed to start work-stealing workers";
+                break;
+            }
+            c->timing = timing_measure(timed_worksteal, &ctx);
+            c->value = (uint128_t)ctx.result;
+            c->used_cutoff = ctx.cutoff;
+            c->used_threads = workers;
+            break;
+        }
+        case FIB_NATIVE_FAST: {
+            FastTimed ctx = { c->n, 0, 0 };
+            int small = c->n <= FIB_U64_MAX_N;
+            c->timing = timing_measure(small ? timed_fast_u64 : timed_fast_u128, &ctx);
+            c->value = small ? fib_fast_doubling_u64(c->n) : fib_fast_doubling_u128(c->n);
+            break;
+        }
+        case FIB_NATIVE_MOD: {
+            FastTimed ctx = { c->n, c->modulus, 0 };
+            c->timing = timing_measure(timed_fast_mod, &ctx);
+            c->value = fib_fast_doubling_mod(c->n, c->modulus);
+            break;
+        }
+        case FIB_NATIVE_BIGINT: {
+            BigTimed ctx = { c->n, { NULL, 0 } };
+#ifdef USE_OPENMP
+            // Perkalian bigint memakai OpenMP task: budget thread seperti mode openmp
+            int saved_threads = omp_get_max_threads();
+            if (c->threads) omp_set_num_threads(c->threads);
+            c->used_threads = omp_get_max_threads();
+#endif
+            c->timing = timing_measure(timed_bigint, &ctx);
+#ifdef USE_OPENMP
+            omp_set_num_threads(saved_threads);
+#endif
+            c->digits = ctx.r.d ? big_to_string(&ctx.r) : NULL;
+            big_free(&ctx.r);
+            if (!c->digits) c->error = "Out of memory (bigint)";
+            break;
+        }
+        default:
+            c->error = "Mode not available in this build";
+            break;
+    }
+}
+
+static void fib_native_execute(napi_env env, void* data) {
+    (void)env;
+    fib_native_run(data);
+}
+
+static void* fib_native_ws_main(void* arg) {
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&fib_native_ws.lock);
+        while (!fib_native_ws.head) pthread_cond_wait(&fib_native_ws.wake, &fib_native_ws.lock);
+        FibNativeCall* c = fib_native_ws.head;
+        fib_native_ws.head = c->next;
+        if (!fib_native_ws.head) fib_native_ws.tail = NULL;
+        pthread_mutex_unlock(&fib_native_ws.lock);
+
+        // c bisa sudah dibebaskan thread utama begitu call kembali
+        napi_threadsafe_function done = c->done;
+        fib_native_run(c);
+        napi_call_threadsafe_function(done, c, napi_tsfn_nonblocking);
+        napi_release_threadsafe_function(done, napi_tsfn_release);
+    }
+    return NULL;
+}
+
+static void fib_native_set_double(napi_env env, napi_value obj, const char* key, double v) {
+    napi_value value;
+    napi_create_double(env, v, &value);
+    napi_set_named_property(env, obj, key, value);
+}
+
+static void fib_native_set_int(napi_env env, napi_value obj, const char* key, int64_t v) {
+    napi_value value;
+    napi_create_int64(env, v, &value);
+    napi_set_named_property(env, obj, key, value);
+}
+
+// Field waktu dengan nama yang sama seperti output JSON program C (print_timing)
+static void fib_native_set_timing(napi_env env, napi_value obj, const Timing* t) {
+    napi_value ci, low, high;
+    fib_native_set_double(env, obj, "time", t->median);
+    fib_native_set_double(env, obj, "time_min", t->min);
+    fib_native_set_double(env, obj, "time_max", t->max);
+    napi_create_array_with_length(env, 2, &ci);
+    napi_create_double(env, t->ci_low, &low);
+    napi_create_double(env, t->ci_high, &high);
+    napi_set_element(env, ci, 0, low);
+    napi_set_element(env, ci, 1, high);
+    napi_set_named_property(env, obj, "time_ci", ci);
+    fib_native_set_double(env, obj, "ci_level", t->ci_level);
+    fib_native_set_int(env, obj, "repetitions", t->repetitions);
+    fib_native_set_int(env, obj, "trials", t->trials);
+}
+
+// Resolve / reject promise panggilan c di thread utama, lalu bebaskan c
+static void fib_native_settle(napi_env env, napi_status status, FibNativeCall* c) {
+    napi_value obj, value;
+
+    if (status != napi_ok || c->error) {
+        napi_value msg, err;
+        napi_create_string_utf8(env, c->error ? c->error : "Fibonacci call cancelled",
+                                NAPI_AUTO_LENGTH, &msg);
+        napi_create_error(env, NULL, msg, &err);
+        napi_reject_deferred(env, c->deferred, err);
+    } else {
+        napi_create_object(env, &obj);
+        napi_create_bigint_uint64(env, c->n, &value);
+        napi_set_named_property(env, obj, "n", value);
+        napi_create_string_utf8(env, fib_native_mode_names[c->mode], NAPI_AUTO_LENGTH, &value);
+        napi_set_named_property(env, obj, "mode", value);
+        if (c->digits) {
+            // BigInt desimal: string (konversi ke BigInt JS untuk jutaan digit mahal)
+            napi_create_string_utf8(env, c->digits, NAPI_AUTO_LENGTH, &value);
+            napi_set_named_property(env, obj, "result", value);
+            fib_native_set_int(env, obj, "digits", (int64_t)strlen(c->digits));
+        } else {
+            uint64_t words[2] = { (uint64_t)c->value, (uint64_t)(c->value >> 64) };
+            napi_create_bigint_words(env, 0, 2, words, &value);
+            napi_set_named_property(env, obj, "result", value);
+        }
+        if (c->mode == FIB_NATIVE_MOD) {
+            napi_create_bigint_uint64(env, c->modulus, &value);
+            napi_set_named_property(env, obj, "modulus", value);
+        }
+        fib_native_set_timing(env, obj, &c->timing);
+        if (c->used_cutoff) fib_native_set_int(env, obj, "cutoff", c->used_cutoff);
+        if (c->used_threads) fib_native_set_int(env, obj, "threads", c->used_threads);
+        napi_resolve_deferred(env, c->deferred, obj);
+    }
+
+    free(c->digits);
+    free(c);
+}
+
+static void fib_native_complete(napi_env env, napi_status status, void* data) {
+    FibNativeCall* c = data;
+    napi_delete_async_work(env, c->work);
+    fib_native_settle(env, status, c);
+}
+
+// Callback threadsafe function mode worksteal; env NULL saat environment ditutup
+static void fib_native_ws_done(napi_env env, napi_value js_cb, void* context, void* data) {
+    FibNativeCall* c = data;
+    (void)js_cb;
+    (void)context;
+    if (!env) {
+        free(c->digits);
+        free(c);
+        return;
+    }
+    fib_native_settle(env, napi_ok, c);
+}
+
+// Antrekan c ke thread work-stealing; return -1 jika thread / threadsafe function
+// tidak bisa dibuat
+static int fib_native_ws_submit(napi_env env, FibNativeCall* c) {
+    napi_value name;
+    napi_create_string_utf8(env, "algokom.fibonacci.worksteal", NAPI_AUTO_LENGTH, &name);
+    if (napi_create_threadsafe_function(env, NULL, NULL, name, 0, 1, NULL, NULL, NULL,
+                                        fib_native_ws_done, &c->done) != napi_ok) {
+        return -1;
+    }
+    pthread_mutex_lock(&fib_native_ws.lock);
+    if (!fib_native_ws.started) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, fib_native_ws_main, NULL) != 0) {
+            pthread_mutex_unlock(&fib_native_ws.lock);
+            napi_release_threadsafe_function(c->done, napi_tsfn_abort);
+            return -1;
+        }
+        pthread_detach(thread);
+        fib_native_ws.started = 1;
+    }
+    if (fib_native_ws.tail) fib_native_ws.tail->next = c;
+    else fib_native_ws.head = c;
+    fib_native_ws.tail = c;
+    pthread_cond_signal(&fib_native_ws.wake);
+    pthread_mutex_unlock(&fib_native_ws.lock);
+    return 0;
+}
+
+// Baca properti angka opsional; return 0 jika tidak ada / undefined
+static int fib_native_get_number(napi_env env, napi_value obj, const char* key, double* out) {
+    bool has = false;
+    napi_value value;
+    napi_valuetype type;
+    if (napi_has_named_property(env, obj, key, &has) != napi_ok || !has) return 0;
+    napi_get_named_property(env, obj, key, &value);
+    napi_typeof(env, value, &type);
+    if (type == napi_undefined) return 0;
+    if (type == napi_bigint) {
+        uint64_t v;
+        bool lossless;
+        napi_get_value_bigint_uint64(env, value, &v, &lossless);
+        *out = (double)v;
+        return lossless ? 1 : -1;
+    }
+    if (type != napi_number) return -1;
+    napi_get_value_double(env, value, out);
+    return 1;
+}
+
+// Baca bilangan bulat tak bertanda 64-bit (number atau BigInt); return 0 jika tidak valid
+static int fib_native_get_u64(napi_env env, napi_value value, uint64_t* out) {
+    napi_valuetype type;
+    napi_typeof(env, value, &type);
+    if (type == napi_bigint) {
+        bool lossless;
+        int64_t sign_check;
+        napi_get_value_bigint_int64(env, value, &sign_check, &lossless);
+        if (sign_check < 0 && lossless) return 0;
+        napi_get_value_bigint_uint64(env, value, out, &lossless);
+        return lossless;
+    }
+    if (type == napi_number) {
+        double d;
+        napi_get_value_double(env, value, &d);
+        if (!(d >= 0.0 && d <= 9007199254740991.0) || d != floor(d)) return 0;
+        *out = (uint64_t)d;
+        return 1;
+    }
+    return 0;
+}
+
+// fibonacci(n, { mode, mod, cutoff, threads, trials, minSample }) -> Promise<object>
+// n: number atau BigInt. Hasil: { n, mode, result (BigInt, string untuk bigint),
+// time, time_min, time_max, time_ci, ci_level, repetitions, trials, cutoff?, threads? }
+static napi_value fib_native_fibonacci(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2], promise, resource_name;
+    napi_get_cb_info(env, info, &argc, argv, NULL, NULL);
+    if (argc < 1) FIB_NATIVE_THROW(env, "fibonacci(n, options): n is required");
+
+    FibNativeCall* c = calloc(1, sizeof(*c));
+    if (!c) FIB_NATIVE_THROW(env, "Out of memory");
+    c->min_sample = -1.0;
+    if (!fib_native_get_u64(env, argv[0], &c->n)) {
+        free(c);
+        FIB_NATIVE_THROW(env, "Invalid n. Must be a non-negative integer");
+    }
+
+    napi_valuetype type = napi_undefined;
+    if (argc > 1) napi_typeof(env, argv[1], &type);
+    if (type == napi_object) {
+        napi_value value;
+        bool has = false, mode_set = false;
+        double d;
+        napi_has_named_property(env, argv[1], "mode", &mode_set);
+        if (mode_set) {
+            char name[16];
+            size_t len;
+            napi_get_named_property(env, argv[1], "mode", &value);
+            if (napi_get_value_string_utf8(env, value, name, sizeof(name), &len) != napi_ok) {
+                free(c);
+                FIB_NATIVE_THROW(env, "Invalid mode");
+            }
+            int found = 0;
+            for (int m = 0; m <= FIB_NATIVE_BIGINT; m++) {
+                if (strcmp(name, fib_native_mode_names[m]) == 0) {
+                    c->mode = (FibNativeMode)m;
+                    found = 1;
+                }
+            }
+            if (!found) {
+                free(c);
+                FIB_NATIVE_THROW(env, "Invalid mode. Must be sequential, openmp, worksteal, fast, mod or bigint");
+            }
+        }
+        napi_has_named_property(env, argv[1], "mod", &has);
+        if (has) {
+            napi_get_named_property(env, argv[1], "mod", &value);
+            if (!fib_native_get_u64(env, value, &c->modulus) || c->modulus == 0) {
+                free(c);
+                FIB_NATIVE_THROW(env, "Invalid modulus. Must be an integer >= 1");
+            }
+            if (!mode_set) c->mode = FIB_NATIVE_MOD;
+        }
+        if (fib_native_get_number(env, argv[1], "cutoff", &d) == 1) {
+            if (d < CUTOFF_MIN || d > CUTOFF_MAX) {
+                free(c);
+                FIB_NATIVE_THROW(env, "Invalid cutoff");
+            }
+            c->cutoff = (int)d;
+        }
+        if (fib_native_get_number(env, argv[1], "threads", &d) == 1) {
+            if (d < 1 || d > WS_MAX_WORKERS) {
+                free(c);
+                FIB_NATIVE_THROW(env, "Invalid threads");
+            }
+            c->threads = (int)d;
+        }
+        if (fib_native_get_number(env, argv[1], "trials", &d) == 1) {
+            if (d < 1 || d > TIMING_TRIALS_LIMIT) {
+                free(c);
+                FIB_NATIVE_THROW(env, "Invalid trials");
+            }
+            c->trials = (int)d;
+        }
+        if (fib_native_get_number(env, argv[1], "minSample", &d) == 1) {
+            if (!(d >= 0.0 && d <= 1.0)) {
+                free(c);
+                FIB_NATIVE_THROW(env, "Invalid minSample. Must be 0..1 seconds");
+            }
+            c->min_sample = d;
+        }
+    }
+
+    // Batas n sama seperti fib_check_n / RECURSIVE_MAX_N di CLI
+    const char* range_error = NULL;
+    switch (c->mode) {
+        case FIB_NATIVE_SEQUENTIAL:
+        case FIB_NATIVE_OPENMP:
+        case FIB_NATIVE_WORKSTEAL:
+            if (c->n > RECURSIVE_MAX_N) range_error = "Recursive modes support n <= 45";
+            break;
+        case FIB_NATIVE_FAST:
+            if (c->n > FIB_U128_MAX_N) range_error = "n > 186 needs mode 'mod' or 'bigint' (F(n) exceeds 128 bits)";
+            break;
+        case FIB_NATIVE_MOD:
+            if (c->modulus == 0) range_error = "Mode 'mod' needs options.mod";
+            break;
+        case FIB_NATIVE_BIGINT:
+            if (c->n > BIGINT_MAX_N) range_error = "Mode 'bigint' supports n <= 500000000";
+            break;
+    }
+#ifndef USE_OPENMP
+    if (c->mode == FIB_NATIVE_OPENMP) range_error = "Addon built without OpenMP";
+#endif
+    if (range_error) {
+        free(c);
+        napi_throw_range_error(env, NULL, range_error);
+        return NULL;
+    }
+
+    napi_create_promise(env, &c->deferred, &promise);
+    if (c->mode == FIB_NATIVE_WORKSTEAL) {
+        if (fib_native_ws_submit(env, c) != 0) {
+            c->error = "Failed to start work-stealing thread";
+            fib_native_settle(env, napi_ok, c);
+        }
+        return promise;
+    }
+    napi_create_string_utf8(env, "algokom.fibonacci", NAPI_AUTO_LENGTH, &resource_name);
+    napi_create_async_work(env, NULL, resource_name, fib_native_execute, fib_native_complete,
+                           c, &c->work);
+    napi_queue_async_work(env, c->work);
+    return promise;
+}
+
+napi_value fib_native_init(napi_env env, napi_value exports) {
+    napi_value fn, modes;
+    napi_create_function(env, "fibonacci", NAPI_AUTO_LENGTH, fib_native_fibonacci, NULL, &fn);
+    napi_set_named_property(env, exports, "fibonacci", fn);
+
+    napi_create_array(env, &modes);
+    uint32_t count = 0;
+    for (int m = 0; m <= FIB_NATIVE_BIGINT; m++) {
+#ifndef USE_OPENMP
+        if (m == FIB_NATIVE_OPENMP) continue;
+#endif
+        napi_value name;
+        napi_create_string_utf8(env, fib_native_mode_names[m], NAPI_AUTO_LENGTH, &name);
+        napi_set_element(env, modes, count++, name);
+    }
+    napi_set_named_property(env, exports, "fibonacciModes", modes);
+    return exports;
+}
@@ -1,11 +1,24 @@
 const express = require("express");
-const { exec } = require("child_process");
+const { spawn, spawnSync } = require("child_process");
+const fs = require("fs");
 const path = require("path");
+const os = require("os");
+const crypto = require("crypto");
+const readline = require("readline");
 const cors = require("cors");
 
 const app = express();
 const PORT = 3000;
 
+// Addon N-API opsional (npm run build:native): kernel C dipanggil di proses ini
+// lewat thread pool libuv, piksel dipertukarkan sebagai Buffer tanpa salinan
+let native = null;
+try {
+  native = require("./native/build/Release/algokom_native.node");
+} catch (err) {
+  native = null;
+}
+
 // Middleware
 app.use(cors());
 app.use(express.json());
@@ -21,89 +34,715 @@ function sanitizeNumericTokens(jsonLike) {
     .replace(/-Infinity/gi, "0");
 }
 
-function clampTime(t) {
-  const min = 1e-9;
-  if (!Number.isFinite(t) || t <= 0) return min;
-  return t;
+// Batas n: program C menjalankan varian rekursif hanya sampai 45; fast doubling
+// eksak sampai F(186) (128-bit), di atas itu (sampai 2^64 - 1) dengan ?mod=m,
+// atau eksak presisi sembarang dengan ?bigint=1 sampai FIB_BIGINT_MAX_N
+const FIB_EXACT_MAX_N = 186n;
+const FIB_BIGINT_MAX_N = 100000000n; // F(10^8) ~ 20.9 juta digit
+const FIB_U64_MAX = (1n << 64n) - 1n;
+// Profil cutoff hasil --autotune (per backend/threads/cpu), disimpan di samping binary
+const FIB_CUTOFF_PROFILE = path.join(__dirname, "fib_cutoff_profile.txt");
+
+// Batas jumlah n per request batch (satu proses untuk semua n)
+const FIB_BATCH_MAX = 256;
+
+// Argumen CLI program Fibonacci (n, daftar ns, dan modulus sudah divalidasi).
+// quick = satu sampel tanpa auto-batching: latensi minimum, timing kasar
+function fibArgs(n, opts = {}) {
+  const args = [opts.ns ? `--ns=${opts.ns}` : `${n}`];
+  if (opts.mod) args.push(`--mod=${opts.mod}`);
+  if (opts.bigint) args.push("--bigint", `--digits=${opts.digits}`);
+  if (opts.autotune) args.push("--autotune", `--profile=${FIB_CUTOFF_PROFILE}`);
+  if (opts.quick) args.push("--trials=1", "--min-sample=0");
+  return args;
 }
 
-function normalizeCilkTimings(result, baseline) {
-  const base = clampTime(baseline);
-  const tiny = 1e-6; // 1 microsecond guard to avoid absurd speedup when timing is missing
-  if (result.cilk_serial) {
-    let t = clampTime(result.cilk_serial.time);
-    if (t < tiny) t = base; // fall back to baseline when timing too small/unreliable
-    result.cilk_serial.time = t;
-    result.cilk_serial.speedup = +(base / t).toFixed(2);
-    result.cilk_serial.overhead = +(((t - base) / base) * 100).toFixed(2);
-  }
-  if (result.cilk_parallel) {
-    let t = clampTime(result.cilk_parallel.time);
-    if (t < tiny) t = base;
-    result.cilk_parallel.time = t;
-    result.cilk_parallel.speedup = +(base / t).toFixed(2);
-  }
-  return result;
+// Timeout per request: bigint butuh waktu lebih lama; batch mendapat timeout lebih
+// panjang karena semua n jalan dalam satu proses
+function fibTimeout(opts = {}) {
+  const scale = opts.ns ? 4 : 1;
+  return (opts.bigint ? 120000 : 30000) * scale;
 }
 
-// Helper untuk menjalankan program Fibonacci berdasarkan mode
-function runFibProgram(mode, n) {
-  return new Promise((resolve, reject) => {
-    const execPath = path.join(
-      __dirname,
-      mode === "cilk" ? "fib_json_cilk" : "fib_omp_json"
-    );
+// ==================== Pool worker C (--worker) ====================
+// Setiap worker adalah proses C berumur panjang (program dijalankan dengan --worker)
+// yang membaca satu request JSON per baris di stdin dan menulis satu baris respons,
+// sehingga request tidak lagi membayar fork + exec + start runtime OpenMP. Satu
+// request aktif per worker, sisanya antre. Worker yang crash, melewati timeout
+// request, atau tidak menjawab ping health check diganti proses baru, dengan jeda
+// eksponensial selama worker terus mati tanpa pernah menjawab. Setelah
+// WORKER_MAX_RESTARTS kegagalan beruntun pool dinonaktifkan: antrean dan request
+// berikutnya ditolak (503) sampai binary-nya diganti.
+const WORKER_PING_INTERVAL = 10000;
+const WORKER_PING_TIMEOUT = 2000;
+const WORKER_RESTART_DELAY = 500;
+const WORKER_RESTART_MAX_DELAY = 30000;
+const WORKER_MAX_RESTARTS = 6;
+
+// Error untuk pool yang tidak tersedia (binary tidak ada / dinonaktifkan)
+function workerUnavailable(message) {
+  const error = new Error(message);
+  error.code = "WORKER_UNAVAILABLE";
+  return error;
+}
+
+// Status HTTP untuk error job C: 503 jika pool-nya tidak tersedia
+function workerErrorStatus(error) {
+  return error && error.code === "WORKER_UNAVAILABLE" ? 503 : 500;
+}
+
+class CWorkerPool {
+  constructor(name, binary, size) {
+    this.name = name;
+    this.execPath = path.join(__dirname, binary);
+    this.size = size;
+    this.workers = new Array(size).fill(null);
+    this.queue = [];
+    this.nextId = 1;
+    this.restarts = 0;
+    this.failures = 0; // exit beruntun tanpa satu pun jawaban yang valid
+    this.disabled = null; // { reason, mtimeMs } setelah WORKER_MAX_RESTARTS
+    setInterval(() => this.healthCheck(), WORKER_PING_INTERVAL).unref();
+  }
+
+  available() {
+    if (!fs.existsSync(this.execPath)) return false;
+    if (this.disabled) {
+      // Binary diganti (mis. di-build ulang): coba lagi dari awal
+      if (fs.statSync(this.execPath).mtimeMs === this.disabled.mtimeMs) return false;
+      console.log(`[${this.name}] ${this.execPath} changed, re-enabling pool`);
+      this.disabled = null;
+      this.failures = 0;
+    }
+    return true;
+  }
+
+  // Jalankan program dengan argumen CLI args; resolve dengan objek respons worker
+  run(args, timeoutMs) {
+    if (!this.available()) {
+      return Promise.reject(
+        workerUnavailable(
+          this.disabled
+            ? `[${this.name}] pool disabled: ${this.disabled.reason}`
+            : `[${this.name}] ${this.execPath} not found`
+        )
+      );
+    }
+    return new Promise((resolve, reject) => {
+      this.queue.push({ args, timeoutMs, resolve, reject });
+      this.dispatch();
+    });
+  }
+
+  spawnWorker(slot) {
+    const child = spawn(this.execPath, ["--worker"], { cwd: __dirname });
+    const worker = { slot, child, job: null, ping: null };
+    readline
+      .createInterface({ input: child.stdout, crlfDelay: Infinity })
+      .on("line", (line) => this.onLine(worker, line));
+    child.stderr.on("data", (data) => {
+      console.warn(`[${this.name} worker ${slot}] stderr:`, data.toString());
+    });
+    // EPIPE saat menulis ke worker yang sedang mati; exit ditangani onExit
+    child.stdin.on("error", (err) => {
+      console.warn(`[${this.name} worker ${slot}] stdin: ${err.message}`);
+    });
+    child.on("error", (err) => {
+      console.error(`[${this.name} worker ${slot}] ${err.message}`);
+    });
+    child.on("exit", (code, signal) => this.onExit(worker, code, signal));
+    this.workers[slot] = worker;
+    return worker;
+  }
+
+  dispatch() {
+    for (let slot = 0; slot < this.size && this.queue.length > 0; slot++) {
+      const worker = this.workers[slot] || this.spawnWorker(slot);
+      if (worker.job) continue;
+      const job = this.queue.shift();
+      const id = this.nextId++;
+      worker.job = {
+        id,
+        ...job,
+        timer: setTimeout(() => {
+          this.finish(worker, new Error(`[${this.name}] timeout after ${job.timeoutMs} ms`));
+          worker.child.kill("SIGKILL"); // onExit menjadwalkan pengganti
+        }, job.timeoutMs),
+      };
+      worker.child.stdin.write(JSON.stringify({ id, args: job.args }) + "\n");
+    }
+  }
+
+  // Selesaikan job aktif worker dengan hasil atau error
+  finish(worker, error, message) {
+    const job = worker.job;
+    if (!job) return;
+    clearTimeout(job.timer);
+    worker.job = null;
+    if (error) job.reject(error);
+    else job.resolve(message);
+  }
 
-    exec(`"${execPath}" ${n}`, { timeout: 30000 }, (error, stdout, stderr) => {
-      if (error) {
-        error.message = `[${mode}] ${error.message}`;
-        return reject(error);
+  onLine(worker, line) {
+    let message;
+    try {
+      message = JSON.parse(line);
+    } catch (parseError) {
+      console.error(`[${this.name}] invalid worker output:`, line.slice(0, 200));
+      return;
+    }
+    if (message.pong) {
+      if (worker.ping && worker.ping.id === message.id) {
+        clearTimeout(worker.ping.timer);
+        worker.ping = null;
+        this.failures = 0;
       }
+      return;
+    }
+    if (worker.job && worker.job.id === message.id) {
+      this.failures = 0;
+      this.finish(worker, null, message);
+      this.dispatch();
+    }
+  }
+
+  onExit(worker, code, signal) {
+    if (this.workers[worker.slot] === worker) this.workers[worker.slot] = null;
+    if (worker.ping) clearTimeout(worker.ping.timer);
+    const reason = `worker exited (${signal || code})`;
+    this.finish(worker, new Error(`[${this.name}] ${reason}`));
+    this.restarts++;
+    this.failures++;
+    if (this.failures >= WORKER_MAX_RESTARTS) {
+      this.disable(`${this.failures} consecutive ${reason} without answering`);
+      return;
+    }
+    const delay = Math.min(WORKER_RESTART_DELAY * 2 ** (this.failures - 1), WORKER_RESTART_MAX_DELAY);
+    setTimeout(() => {
+      if (!this.workers[worker.slot] && this.available()) this.spawnWorker(worker.slot);
+      this.dispatch();
+    }, delay).unref();
+  }
 
-      if (stderr) {
-        console.warn(`[${mode}] stderr:`, stderr);
+  // Hentikan restart dan tolak antrean; available() mengaktifkan lagi jika binary berubah
+  disable(reason) {
+    if (this.disabled) return;
+    let mtimeMs = 0;
+    try {
+      mtimeMs = fs.statSync(this.execPath).mtimeMs;
+    } catch (statError) {
+      // binary hilang: available() sudah false
+    }
+    this.disabled = { reason, mtimeMs };
+    console.error(`[${this.name}] pool disabled: ${reason}`);
+    for (const worker of this.workers) {
+      if (worker) worker.child.kill("SIGKILL");
+    }
+    for (const job of this.queue.splice(0)) {
+      job.reject(workerUnavailable(`[${this.name}] pool disabled: ${reason}`));
+    }
+  }
+
+  // Ping worker yang sedang idle; tanpa pong dalam WORKER_PING_TIMEOUT = hang, dibunuh
+  healthCheck() {
+    for (const worker of this.workers) {
+      if (!worker || worker.job || worker.ping) continue;
+      const id = this.nextId++;
+      worker.ping = {
+        id,
+        timer: setTimeout(() => worker.child.kill("SIGKILL"), WORKER_PING_TIMEOUT),
+      };
+      worker.child.stdin.write(JSON.stringify({ id, op: "ping" }) + "\n");
+    }
+  }
+
+  stats() {
+    return {
+      available: this.available(),
+      disabled: this.disabled ? this.disabled.reason : null,
+      workers: this.workers.filter(Boolean).length,
+      size: this.size,
+      busy: this.workers.filter((w) => w && w.job).length,
+      queued: this.queue.length,
+      restarts: this.restarts,
+    };
+  }
+}
+
+// ==================== Scheduler core (admission) ====================
+// Setiap job C/addon meminta sejumlah core dan baru dijalankan setelah core tsb
+// dialokasikan, sehingga job yang berjalan bersamaan tidak saling oversubscribe.
+// Job menerima budget eksplisit (--threads=N --cpus=LIST, atau threads untuk addon).
+// Antrean FIFO: job di kepala harus masuk dulu agar job besar tidak kelaparan.
+// Job biasa mendapat min(diminta, core bebas, bagian adil dari job aktif + antre)
+// selama >= minCores; job eksklusif (benchmark, autotune, kurva speedup) menunggu
+// semua job lain selesai dan memegang semua core sendirian.
+const SCHED_CORES =
+  parseInt(process.env.SCHED_CORES) ||
+  (os.availableParallelism ? os.availableParallelism() : os.cpus().length);
+const SCHED_WAIT_WINDOW = 256; // jumlah waktu tunggu terakhir untuk p50/p95
+
+// [0,1,2,3,6] -> "0-3,6"
+function formatCpuList(cores) {
+  const parts = [];
+  for (let i = 0; i < cores.length; i++) {
+    let j = i;
+    while (j + 1 < cores.length && cores[j + 1] === cores[j] + 1) j++;
+    parts.push(j > i ? `${cores[i]}-${cores[j]}` : `${cores[i]}`);
+    i = j;
+  }
+  return parts.join(",");
+}
+
+class CoreScheduler {
+  constructor(total) {
+    this.total = total;
+    this.free = Array.from({ length: total }, (_, i) => i); // id core bebas
+    this.queue = []; // { label, want, min, exclusive, pool, enqueued, resolve }
+    this.running = new Map(); // id lease -> lease
+    this.poolBusy = new Map(); // CWorkerPool -> lease yang sedang memakai worker-nya
+    this.exclusiveRunning = false;
+    this.seq = 0;
+    this.waits = []; // waktu tunggu terakhir (ms)
+    this.counters = { admitted: 0, completed: 0, exclusive: 0, wait_max_ms: 0, wait_total_ms: 0 };
+  }
+
+  // Jalankan fn(lease) dengan core yang dialokasikan; core dilepas setelah selesai
+  async run(spec, fn) {
+    const lease = await this.acquire(spec);
+    try {
+      return await fn(lease);
+    } finally {
+      this.release(lease);
+    }
+  }
+
+  // pool: CWorkerPool yang menjalankan job. Job baru diberi core bila pool tsb masih
+  // punya worker bebas, sehingga core tidak menganggur di antrean pool dan waktu
+  // tunggu worker ikut tercatat di statistik scheduler.
+  acquire({ label, cores = this.total, minCores = 1, exclusive = false, pool = null }) {
+    const want = Math.max(1, Math.min(cores, this.total));
+    const min = Math.max(1, Math.min(minCores, want));
+    return new Promise((resolve) => {
+      this.queue.push({ label, want, min, exclusive, pool, enqueued: Date.now(), resolve });
+      this.pump();
+    });
+  }
+
+  poolFull(pool) {
+    return pool !== null && (this.poolBusy.get(pool) || 0) >= pool.size;
+  }
+
+  pump() {
+    while (this.queue.length > 0 && !this.exclusiveRunning) {
+      // Job terdepan yang worker pool-nya tersedia; job yang pool-nya penuh tetap di
+      // posisinya. Job eksklusif tidak pernah dilewati (menunggu semua lease selesai).
+      const index = this.queue.findIndex((j) => j.exclusive || !this.poolFull(j.pool));
+      if (index < 0) return;
+      const job = this.queue[index];
+      let count;
+      if (job.exclusive) {
+        if (this.running.size > 0) return;
+        count = this.total;
+      } else {
+        const share = Math.ceil(this.total / (this.running.size + this.queue.length));
+        count = Math.min(job.want, this.free.length, Math.max(job.min, share));
+        if (count < job.min) return;
       }
+      this.queue.splice(index, 1);
+      if (job.pool) this.poolBusy.set(job.pool, (this.poolBusy.get(job.pool) || 0) + 1);
 
-      try {
-        const sanitized = sanitizeNumericTokens(stdout);
-        const result = JSON.parse(sanitized);
-        resolve(result);
-      } catch (parseError) {
-        reject(
-          new Error(
-            `[${mode}] Failed to parse C program output: ${parseError.message}`
-          )
-        );
+      this.free.sort((a, b) => a - b);
+      const cores = this.free.splice(0, count);
+      const now = Date.now();
+      const waited = now - job.enqueued;
+      const lease = {
+        id: ++this.seq,
+        label: job.label,
+        cores,
+        threads: cores.length,
+        cpus: formatCpuList(cores),
+        exclusive: job.exclusive,
+        pool: job.pool,
+        started: now,
+        waited_ms: waited,
+      };
+      this.running.set(lease.id, lease);
+      if (job.exclusive) {
+        this.exclusiveRunning = true;
+        this.counters.exclusive++;
       }
-    });
+      this.counters.admitted++;
+      this.counters.wait_total_ms += waited;
+      this.counters.wait_max_ms = Math.max(this.counters.wait_max_ms, waited);
+      this.waits.push(waited);
+      if (this.waits.length > SCHED_WAIT_WINDOW) this.waits.shift();
+      job.resolve(lease);
+    }
+  }
+
+  release(lease) {
+    if (!this.running.delete(lease.id)) return;
+    this.free.push(...lease.cores);
+    if (lease.pool) this.poolBusy.set(lease.pool, this.poolBusy.get(lease.pool) - 1);
+    if (lease.exclusive) this.exclusiveRunning = false;
+    this.counters.completed++;
+    this.pump();
+  }
+
+  stats() {
+    const now = Date.now();
+    const sorted = [...this.waits].sort((a, b) => a - b);
+    const pct = (p) => (sorted.length ? sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))] : 0);
+    return {
+      cores_total: this.total,
+      cores_free: this.free.length,
+      queue_depth: this.queue.length,
+      running: [...this.running.values()].map((l) => ({
+        label: l.label,
+        cpus: l.cpus,
+        exclusive: l.exclusive,
+        running_ms: now - l.started,
+      })),
+      queued: this.queue.map((j) => ({
+        label: j.label,
+        cores: j.want,
+        exclusive: j.exclusive,
+        ...(j.pool && { pool: j.pool.name, pool_full: this.poolFull(j.pool) }),
+        waiting_ms: now - j.enqueued,
+      })),
+      admitted: this.counters.admitted,
+      completed: this.counters.completed,
+      exclusive_jobs: this.counters.exclusive,
+      wait_avg_ms: this.counters.admitted ? this.counters.wait_total_ms / this.counters.admitted : 0,
+      wait_p50_ms: pct(0.5),
+      wait_p95_ms: pct(0.95),
+      wait_max_ms: this.counters.wait_max_ms,
+    };
+  }
+}
+
+const scheduler = new CoreScheduler(SCHED_CORES);
+
+// Argumen budget untuk program C (fibonacci_json.c / bilinear_serial_parallel.c)
+function leaseArgs(lease) {
+  return [`--threads=${lease.threads}`, `--cpus=${lease.cpus}`];
+}
+
+// Binary lama (sebelum --worker) tidak menjawab ping: probe sekali saat start
+function supportsWorkerMode(binary) {
+  const probe = spawnSync(path.join(__dirname, binary), ["--worker"], {
+    cwd: __dirname,
+    input: JSON.stringify({ id: 0, op: "ping" }) + "\n",
+    timeout: WORKER_PING_TIMEOUT,
   });
+  return !probe.error && /"pong":\s*true/.test(String(probe.stdout));
 }
 
+// fib_json_cilk butuh compiler OpenCilk; tanpa build baru (dengan --worker) mode cilk
+// dinonaktifkan alih-alih menjalankan binary lama yang terus crash
+const FIB_CILK_WORKER = supportsWorkerMode("fib_json_cilk");
+if (!FIB_CILK_WORKER) {
+  console.warn("⚠️  fib_json_cilk missing or without --worker support: mode cilk disabled " +
+    "(rebuild it with OpenCilk and restart the server)");
+}
+
+const fibPools = {
+  openmp: new CWorkerPool("openmp", "fib_omp_json", parseInt(process.env.FIB_WORKERS) || 2),
+  cilk: FIB_CILK_WORKER
+    ? new CWorkerPool("cilk", "fib_json_cilk", parseInt(process.env.FIB_WORKERS) || 2)
+    : null,
+};
+// Program bilinear menulis result_*.ppm/png tetap di direktori server: satu worker
+const bilinearPool = new CWorkerPool("bilinear", "bilinear", 1);
+
+// Expand spesifikasi ns ("20..45", "10,20,30", "20..40:5") menjadi daftar BigInt;
+// null jika format tidak valid atau lebih dari FIB_BATCH_MAX nilai
+function parseFibNs(spec) {
+  if (typeof spec !== "string" || !/^\d{1,20}(\.\.\d{1,20}(:\d{1,20})?)?(,\d{1,20}(\.\.\d{1,20}(:\d{1,20})?)?)*$/.test(spec)) {
+    return null;
+  }
+  const ns = [];
+  for (const item of spec.split(",")) {
+    const [range, stepText] = item.split(":");
+    const [loText, hiText = loText] = range.split("..");
+    const lo = BigInt(loText);
+    const hi = BigInt(hiText);
+    const step = stepText === undefined ? 1n : BigInt(stepText);
+    if (hi < lo || step < 1n || hi > FIB_U64_MAX) return null;
+    for (let v = lo; v <= hi; v += step) {
+      if (ns.length >= FIB_BATCH_MAX) return null;
+      ns.push(v);
+    }
+  }
+  return ns;
+}
+
+// Gabungkan hasil OpenCilk ke hasil OpenMP (mode "both"). Waktu dan speedup Cilk
+// dipakai apa adanya: median hasil ukur program C terhadap baseline sekuensialnya sendiri
+function mergeCilkResult(openmpRes, cilkRes, cilkErr) {
+  const merged = { ...openmpRes };
+  if (cilkRes) {
+    merged.cilk_available = true;
+    if (cilkRes.cilk_serial) merged.cilk_serial = cilkRes.cilk_serial;
+    if (cilkRes.cilk_parallel) merged.cilk_parallel = cilkRes.cilk_parallel;
+  } else {
+    merged.cilk_available = false;
+    merged.cilk_error = cilkErr || "OpenCilk binary not available";
+  }
+  return merged;
+}
+
+// Permintaan core job Fibonacci. Kurva speedup (batch) dan autotune = eksklusif;
+// OpenCilk menentukan jumlah worker sekali saat start (CILK_NWORKERS), jadi job
+// Cilk meminta semua core. n di atas batas rekursif tanpa bigint = satu core.
+function fibJobSpec(mode, n, opts) {
+  const label = `fibonacci/${mode}${opts.ns ? ` ns=${opts.ns}` : ` n=${n}`}`;
+  if (opts.ns || opts.autotune) return { label, exclusive: true };
+  if (mode === "cilk") return { label, cores: SCHED_CORES, minCores: SCHED_CORES };
+  if (!opts.bigint && BigInt(n) > 45n) return { label, cores: 1 };
+  return { label, cores: SCHED_CORES };
+}
+
+// Helper untuk menjalankan program Fibonacci berdasarkan mode (lewat scheduler
+// core lalu pool worker)
+function runFibProgram(mode, n, opts) {
+  const pool = mode === "cilk" ? fibPools.cilk : fibPools.openmp;
+  if (!pool) {
+    return Promise.reject(workerUnavailable("OpenCilk binary not available (no --worker support)"));
+  }
+  return scheduler.run({ ...fibJobSpec(mode, n, opts), pool }, (lease) =>
+    pool.run([...fibArgs(n, opts), ...leaseArgs(lease)], fibTimeout(opts))
+  ).then((message) => {
+    if (message.exit !== 0 || !message.result || message.result.error) {
+      throw new Error(
+        `[${mode}] ${message.result?.error || `program exited with ${message.exit}`}`
+      );
+    }
+    return message.result;
+  });
+}
+
+// Jalankan job satu per satu; hasil berformat sama seperti Promise.allSettled
+async function runFibSequence(jobs) {
+  const results = [];
+  for (const job of jobs) {
+    try {
+      results.push({ status: "fulfilled", value: await job() });
+    } catch (reason) {
+      results.push({ status: "rejected", reason });
+    }
+  }
+  return results;
+}
+
+// API endpoint batch: banyak n dalam satu proses C (satu warm-up, thread pool
+// dipakai ulang), mis. /api/fibonacci/batch?ns=20..45 untuk kurva speedup.
+// Response: array objek dengan format sama seperti /api/fibonacci/:n
+app.get("/api/fibonacci/batch", (req, res) => {
+  const mode = req.query.mode || "openmp";
+  const mod = req.query.mod;
+  const bigint = req.query.bigint === "1" || req.query.bigint === "true";
+  const digits = req.query.digits || "summary";
+  const autotune = req.query.autotune === "1" || req.query.autotune === "true";
+  const quick = req.query.quick === "1" || req.query.quick === "true";
+
+  const ns = parseFibNs(req.query.ns);
+  if (!ns) {
+    return res.status(400).json({
+      error: `Invalid ns. Use A,B,C or A..B[:STEP] with at most ${FIB_BATCH_MAX} values`,
+    });
+  }
+  if (mod !== undefined &&
+      (!/^\d{1,20}$/.test(mod) || BigInt(mod) < 1n || BigInt(mod) > FIB_U64_MAX)) {
+    return res.status(400).json({
+      error: "Invalid mod. Must be an integer between 1 and 2^64 - 1",
+    });
+  }
+  if (!["summary", "full"].includes(digits)) {
+    return res.status(400).json({
+      error: "Invalid digits. Must be 'summary' or 'full'",
+    });
+  }
+  const maxN = ns.reduce((a, b) => (b > a ? b : a), 0n);
+  if (bigint && maxN > FIB_BIGINT_MAX_N) {
+    return res.status(400).json({
+      error: `Invalid ns. N must be at most ${FIB_BIGINT_MAX_N} with ?bigint=1`,
+    });
+  }
+  if (mod === undefined && !bigint && maxN > FIB_EXACT_MAX_N) {
+    return res.status(400).json({
+      error: `Invalid ns. N above ${FIB_EXACT_MAX_N} needs ?mod=m or ?bigint=1 (F(n) exceeds 128 bits)`,
+    });
+  }
+  if (!["openmp", "cilk", "worksteal", "both"].includes(mode)) {
+    return res.status(400).json({
+      error: "Invalid mode. Must be 'openmp', 'cilk', 'worksteal', or 'both'",
+    });
+  }
+  const fibOpts = {
+    ns: req.query.ns,
+    mod: mod === undefined ? null : BigInt(mod).toString(),
+    bigint,
+    digits,
+    autotune,
+    quick,
+  };
+
+  if (mode !== "both") {
+    runFibProgram(mode, null, fibOpts)
+      .then((results) => res.json(results))
+      .catch((error) =>
+        res.status(workerErrorStatus(error)).json({
+          error: "Failed to execute C program",
+          details: error.message,
+        })
+      );
+    return;
+  }
+
+  // Berurutan: dua program paralel bersamaan saling berebut core dan merusak timing
+  runFibSequence([
+    () => runFibProgram("openmp", null, fibOpts),
+    () => runFibProgram("cilk", null, fibOpts),
+  ]).then((results) => {
+    if (results[0].status !== "fulfilled") {
+      return res.status(workerErrorStatus(results[0].reason)).json({
+        error: "Failed to execute OpenMP Fibonacci program",
+        details: results[0].reason?.message || "Unknown error",
+      });
+    }
+    const cilkRes = results[1].status === "fulfilled" ? results[1].value : null;
+    const cilkErr = results[1].status === "rejected" ? results[1].reason?.message : null;
+    res.json(
+      results[0].value.map((openmpRes, i) =>
+        mergeCilkResult(openmpRes, cilkRes ? cilkRes[i] : null, cilkErr)
+      )
+    );
+  });
+});
+
 // API endpoint untuk menjalankan program C Fibonacci
+// API endpoint Fibonacci lewat addon N-API: satu varian per request, hasil langsung
+// dari struct C (tanpa proses, tanpa parsing stdout). BigInt dikirim sebagai string.
+app.get("/api/fibonacci/native/:n", (req, res) => {
+  if (!native) {
+    return res.status(503).json({
+      error: "Native addon not built. Run: npm run build:native",
+    });
+  }
+  if (!/^\d{1,20}$/.test(req.params.n) || BigInt(req.params.n) > FIB_U64_MAX) {
+    return res.status(400).json({ error: "Invalid n. Must be a non-negative integer" });
+  }
+  const opts = { mode: req.query.mode || (req.query.mod ? "mod" : "sequential") };
+  // Batas bigint sama seperti route worker (addon sendiri mengizinkan sampai 5e8)
+  if (opts.mode === "bigint" && BigInt(req.params.n) > FIB_BIGINT_MAX_N) {
+    return res.status(400).json({
+      error: `Invalid input. N must be at most ${FIB_BIGINT_MAX_N} with mode=bigint`,
+    });
+  }
+  if (req.query.mod !== undefined) {
+    if (!/^\d{1,20}$/.test(req.query.mod)) {
+      return res.status(400).json({ error: "Invalid modulus. Must be an integer >= 1" });
+    }
+    opts.mod = BigInt(req.query.mod);
+  }
+  for (const key of ["cutoff", "threads", "trials"]) {
+    if (req.query[key] === undefined) continue;
+    if (!/^\d{1,4}$/.test(req.query[key])) {
+      return res.status(400).json({ error: `Invalid ${key}. Must be a positive integer` });
+    }
+    opts[key] = parseInt(req.query[key]);
+  }
+  if (req.query.quick === "1" || req.query.quick === "true") {
+    opts.trials = 1;
+    opts.minSample = 0;
+  }
+
+  // Mode paralel (rekursif dan perkalian bigint) memakai budget core dari scheduler
+  const parallel = ["openmp", "worksteal", "bigint"].includes(opts.mode);
+  const spec = {
+    label: `native/fibonacci/${opts.mode} n=${req.params.n}`,
+    cores: parallel ? opts.threads || SCHED_CORES : 1,
+  };
+  scheduler
+    .run(spec, (lease) => {
+      if (parallel) opts.threads = lease.threads;
+      return native.fibonacci(BigInt(req.params.n), opts);
+    })
+    .then((result) => {
+      res.json({
+        ...result,
+        n: result.n.toString(),
+        result: result.result.toString(),
+        ...(result.modulus !== undefined && { modulus: result.modulus.toString() }),
+      });
+    })
+    .catch((error) => {
+      // Validasi argumen di addon melempar TypeError/RangeError secara sinkron
+      const status = error instanceof TypeError || error instanceof RangeError ? 400 : 500;
+      res.status(status).json({ error: error.message });
+    });
+});
+
 app.get("/api/fibonacci/:n", (req, res) => {
-  const n = parseInt(req.params.n);
   const mode = req.query.mode || "openmp"; // Default to OpenMP
+  const mod = req.query.mod;
+  const bigint = req.query.bigint === "1" || req.query.bigint === "true";
+  const digits = req.query.digits || "summary";
+  const autotune = req.query.autotune === "1" || req.query.autotune === "true";
+  const quick = req.query.quick === "1" || req.query.quick === "true";
 
-  // Validasi input
-  if (isNaN(n) || n < 0 || n > 45) {
+  // Validasi input (string digit, dibandingkan sebagai BigInt agar n 64-bit tetap eksak)
+  if (!/^\d{1,20}$/.test(req.params.n) || BigInt(req.params.n) > FIB_U64_MAX) {
+    return res.status(400).json({
+      error: "Invalid input. N must be an integer between 0 and 2^64 - 1",
+    });
+  }
+  if (mod !== undefined &&
+      (!/^\d{1,20}$/.test(mod) || BigInt(mod) < 1n || BigInt(mod) > FIB_U64_MAX)) {
+    return res.status(400).json({
+      error: "Invalid mod. Must be an integer between 1 and 2^64 - 1",
+    });
+  }
+  if (!["summary", "full"].includes(digits)) {
+    return res.status(400).json({
+      error: "Invalid digits. Must be 'summary' or 'full'",
+    });
+  }
+  const n = BigInt(req.params.n).toString();
+  if (bigint && BigInt(n) > FIB_BIGINT_MAX_N) {
     return res.status(400).json({
-      error: "Invalid input. N must be between 0 and 45",
+      error: `Invalid input. N must be at most ${FIB_BIGINT_MAX_N} with ?bigint=1`,
     });
   }
+  if (mod === undefined && !bigint && BigInt(n) > FIB_EXACT_MAX_N) {
+    return res.status(400).json({
+      error: `Invalid input. N above ${FIB_EXACT_MAX_N} needs ?mod=m or ?bigint=1 (F(n) exceeds 128 bits)`,
+    });
+  }
+  const fibOpts = {
+    mod: mod === undefined ? null : BigInt(mod).toString(),
+    bigint,
+    digits,
+    autotune,
+    quick,
+  };
 
-  // Validasi mode
-  if (!["openmp", "cilk", "both"].includes(mode)) {
+  // Validasi mode ("worksteal" = runtime work-stealing bawaan di binary OpenMP,
+  // tidak butuh compiler OpenCilk)
+  if (!["openmp", "cilk", "worksteal", "both"].includes(mode)) {
     return res.status(400).json({
-      error: "Invalid mode. Must be 'openmp', 'cilk', or 'both'",
+      error: "Invalid mode. Must be 'openmp', 'cilk', 'worksteal', or 'both'",
     });
   }
 
   // Mode kombinasi: jalankan OpenMP dan OpenCilk lalu gabungkan hasilnya
   if (mode === "both") {
-    const openmpPromise = runFibProgram("openmp", n);
-    const cilkPromise = runFibProgram("cilk", n);
-
-    Promise.allSettled([openmpPromise, cilkPromise]).then((results) => {
+    runFibSequence([
+      () => runFibProgram("openmp", n, fibOpts),
+      () => runFibProgram("cilk", n, fibOpts),
+    ]).then((results) => {
       const openmpRes =
         results[0].status === "fulfilled" ? results[0].value : null;
       const cilkRes =
@@ -113,7 +752,7 @@ app.get("/api/fibonacci/:n", (req, res) => {
 
       if (!openmpRes) {
         // OpenMP harus ada; kalau gagal, balikan error
-        return res.status(500).json({
+        return res.status(workerErrorStatus(results[0].reason)).json({
           error: "Failed to execute OpenMP Fibonacci program",
           details:
             results[0].status === "rejected"
@@ -122,71 +761,322 @@ app.get("/api/fibonacci/:n", (req, res) => {
         });
       }
 
-      const merged = { ...openmpRes };
-
-      if (cilkRes) {
-        merged.cilk_available = true;
-        if (cilkRes.cilk_serial) merged.cilk_serial = cilkRes.cilk_serial;
-        if (cilkRes.cilk_parallel) merged.cilk_parallel = cilkRes.cilk_parallel;
-        // Recalculate Cilk timings/speedup with baseline from sequential result
-        normalizeCilkTimings(merged, merged.sequential.time);
-      } else {
-        merged.cilk_available = false;
-        merged.cilk_error = cilkErr || "OpenCilk binary not available";
-      }
-
-      return res.json(merged);
+      return res.json(mergeCilkResult(openmpRes, cilkRes, cilkErr));
     });
     return;
   }
 
-  // Path ke executable C berdasarkan mode
-  const execPath = path.join(
-    __dirname,
-    mode === "cilk" ? "fib_json_cilk" : "fib_omp_json"
-  );
-
-  // Jalankan program C dengan quoted path untuk handling spasi
-  exec(`"${execPath}" ${n}`, { timeout: 30000 }, (error, stdout, stderr) => {
-    if (error) {
+  runFibProgram(mode, n, fibOpts)
+    .then((result) => res.json(result))
+    .catch((error) => {
       console.error("Execution error:", error);
-      return res.status(500).json({
+      res.status(workerErrorStatus(error)).json({
         error: "Failed to execute C program",
         details: error.message,
       });
+    });
+});
+
+// ==================== Cache hasil bilinear (content-addressed) ====================
+// Kunci = sha256(isi file input) + skala + kernel, sehingga hasil tidak bergantung
+// pada nama file dan request identik tidak menghitung ulang. Setiap entry = PNG hasil
+// (<kunci>.png) + metadata (<kunci>.json) di BILINEAR_CACHE_DIR. Dua LRU terpisah:
+// disk (batas total byte, urutan dari waktu akses) dan memori (PNG + metadata
+// entry terpanas). Request identik yang datang saat entry sedang dihitung menunggu
+// Promise yang sama (in-flight dedupe). Program C menulis ke prefix sementara unik
+// (--out) lalu di-rename atomik, jadi job bersamaan tidak saling menimpa.
+const BILINEAR_CACHE_DIR = path.join(__dirname, "cache", "bilinear");
+const BILINEAR_CACHE_DISK_MAX = (parseInt(process.env.BILINEAR_CACHE_DISK_MB) || 512) * 1024 * 1024;
+const BILINEAR_CACHE_MEMORY_MAX = (parseInt(process.env.BILINEAR_CACHE_MEMORY_MB) || 64) * 1024 * 1024;
+const BILINEAR_CACHE_KEY = /^[0-9a-f]{32}-s[0-9.]+-(double|fixed|simd)$/;
+
+class BilinearCache {
+  constructor(dir, diskMax, memoryMax) {
+    this.dir = dir;
+    this.diskMax = diskMax;
+    this.memoryMax = memoryMax;
+    this.disk = new Map(); // kunci -> byte di disk; urutan Map = urutan LRU
+    this.diskBytes = 0;
+    this.memory = new Map(); // kunci -> { meta, png }
+    this.memoryBytes = 0;
+    this.inflight = new Map(); // kunci -> Promise<{ meta, png }>
+    this.hashes = new Map(); // path input -> { mtimeMs, size, hash }
+    this.counters = { memory_hits: 0, disk_hits: 0, misses: 0, deduplicated: 0, evictions: 0 };
+    this.tmpSeq = 0;
+
+    // Index disk dibangun ulang dari isi direktori (LRU awal = urutan mtime)
+    fs.mkdirSync(dir, { recursive: true });
+    const entries = [];
+    for (const name of fs.readdirSync(dir)) {
+      const full = path.join(dir, name);
+      if (name.startsWith(".tmp-")) {
+        fs.rmSync(full, { force: true }); // sisa job yang terputus
+        continue;
+      }
+      const key = name.replace(/\.(png|json)$/, "");
+      if (!name.endsWith(".png") || !BILINEAR_CACHE_KEY.test(key)) continue;
+      if (!fs.existsSync(path.join(dir, `${key}.json`))) continue;
+      const stat = fs.statSync(full);
+      entries.push({ key, bytes: stat.size, used: stat.mtimeMs });
     }
+    entries.sort((a, b) => a.used - b.used);
+    for (const { key, bytes } of entries) this.addDisk(key, bytes);
+  }
+
+  // Hash isi file input; dihitung ulang hanya jika mtime/ukuran berubah
+  async hashFile(file) {
+    const stat = await fs.promises.stat(file);
+    const known = this.hashes.get(file);
+    if (known && known.mtimeMs === stat.mtimeMs && known.size === stat.size) {
+      return known.hash;
+    }
+    const hash = crypto
+      .createHash("sha256")
+      .update(await fs.promises.readFile(file))
+      .digest("hex")
+      .slice(0, 32);
+    this.hashes.set(file, { mtimeMs: stat.mtimeMs, size: stat.size, hash });
+    return hash;
+  }
+
+  pngPath(key) {
+    return path.join(this.dir, `${key}.png`);
+  }
 
-    if (stderr) {
-      console.warn("stderr:", stderr);
+  // Ambil entry: memori -> disk -> compute(prefix) (sekali untuk request identik)
+  async get(key, compute) {
+    const hot = this.memory.get(key);
+    if (hot) {
+      this.memory.delete(key);
+      this.memory.set(key, hot);
+      this.touchDisk(key);
+      this.counters.memory_hits++;
+      return { ...hot, cache: "memory" };
+    }
+    const pending = this.inflight.get(key);
+    if (pending) {
+      this.counters.deduplicated++;
+      return { ...(await pending), cache: "inflight" };
     }
 
+    const job = this.load(key, compute);
+    this.inflight.set(key, job);
     try {
-      // Parse JSON output dari program C
-      const sanitized = sanitizeNumericTokens(stdout);
-      let result = JSON.parse(sanitized);
+      return await job;
+    } finally {
+      this.inflight.delete(key);
+    }
+  }
 
-      // Normalisasi khusus Cilk untuk menghindari speedup absurd jika waktu 0
-      if (mode === "cilk") {
-        normalizeCilkTimings(result, result.sequential?.time || 0);
+  async load(key, compute) {
+    if (this.disk.has(key)) {
+      try {
+        const [png, meta] = await Promise.all([
+          fs.promises.readFile(this.pngPath(key)),
+          fs.promises.readFile(path.join(this.dir, `${key}.json`), "utf8"),
+        ]);
+        const entry = { meta: JSON.parse(meta), png };
+        this.touchDisk(key);
+        this.addMemory(key, entry);
+        this.counters.disk_hits++;
+        return { ...entry, cache: "disk" };
+      } catch (err) {
+        this.removeDisk(key); // file hilang/rusak: hitung ulang
       }
+    }
 
-      res.json(result);
-    } catch (parseError) {
-      console.error("Parse error:", parseError);
-      console.log("stdout:", stdout);
-      res.status(500).json({
-        error: "Failed to parse C program output",
-        output: stdout,
-      });
+    this.counters.misses++;
+    const prefix = path.join(this.dir, `.tmp-${process.pid}-${++this.tmpSeq}`);
+    try {
+      const meta = await compute(prefix);
+      const png = await fs.promises.readFile(`${prefix}_serial.png`);
+      await fs.promises.writeFile(path.join(this.dir, `${key}.json`), JSON.stringify(meta));
+      await fs.promises.rename(`${prefix}_serial.png`, this.pngPath(key));
+      const entry = { meta, png };
+      this.addDisk(key, png.length);
+      this.addMemory(key, entry);
+      return { ...entry, cache: "miss" };
+    } finally {
+      // Semua file job ini (_serial.*, _parallel_<T>.*)
+      const base = path.basename(prefix);
+      for (const name of await fs.promises.readdir(this.dir).catch(() => [])) {
+        if (name.startsWith(`${base}_`)) {
+          fs.promises.rm(path.join(this.dir, name), { force: true }).catch(() => {});
+        }
+      }
     }
-  });
-});
+  }
+
+  addMemory(key, entry) {
+    if (entry.png.length > this.memoryMax) return;
+    this.memory.set(key, entry);
+    this.memoryBytes += entry.png.length;
+    for (const [old, { png }] of this.memory) {
+      if (this.memoryBytes <= this.memoryMax) break;
+      this.memory.delete(old);
+      this.memoryBytes -= png.length;
+    }
+  }
+
+  addDisk(key, bytes) {
+    if (this.disk.has(key)) this.diskBytes -= this.disk.get(key);
+    this.disk.delete(key);
+    this.disk.set(key, bytes);
+    this.diskBytes += bytes;
+    for (const old of this.disk.keys()) {
+      if (this.diskBytes <= this.diskMax || old === key) break;
+      this.removeDisk(old);
+      this.counters.evictions++;
+    }
+  }
 
-// API endpoint untuk Bilinear Interpolation
-app.get("/api/bilinear", (req, res) => {
+  touchDisk(key) {
+    const bytes = this.disk.get(key);
+    if (bytes === undefined) return;
+    this.disk.delete(key);
+    this.disk.set(key, bytes);
+    // mtime = waktu akses terakhir, dipakai saat index dibangun ulang
+    const now = new Date();
+    fs.promises.utimes(this.pngPath(key), now, now).catch(() => {});
+  }
+
+  removeDisk(key) {
+    const bytes = this.disk.get(key);
+    if (bytes !== undefined) this.diskBytes -= bytes;
+    this.disk.delete(key);
+    const hot = this.memory.get(key);
+    if (hot) {
+      this.memory.delete(key);
+      this.memoryBytes -= hot.png.length;
+    }
+    fs.promises.rm(this.pngPath(key), { force: true }).catch(() => {});
+    fs.promises.rm(path.join(this.dir, `${key}.json`), { force: true }).catch(() => {});
+  }
+
+  stats() {
+    return {
+      ...this.counters,
+      disk_entries: this.disk.size,
+      disk_bytes: this.diskBytes,
+      disk_max: this.diskMax,
+      memory_entries: this.memory.size,
+      memory_bytes: this.memoryBytes,
+      memory_max: this.memoryMax,
+      inflight: this.inflight.size,
+    };
+  }
+}
+
+const bilinearCache = new BilinearCache(
+  BILINEAR_CACHE_DIR,
+  BILINEAR_CACHE_DISK_MAX,
+  BILINEAR_CACHE_MEMORY_MAX
+);
+
+// Ekstrak metadata dari output teks program bilinear
+function parseBilinearOutput(stdout, imageFile) {
+  try {
+    // Parse output dari program C
+    // Program mengeluarkan teks, kita extract info penting
+    const lines = stdout.split("\n");
+
+    // Extract metadata
+    let origW = 0,
+      origH = 0,
+      newW = 0,
+      newH = 0;
+    let serialTime = 0;
+    let parallelResults = [];
+
+    for (let i = 0; i < lines.length; i++) {
+      const line = lines[i];
+
+      if (line.includes("Berhasil membaca PNG:")) {
+        const match = line.match(/(\d+)x(\d+)/);
+        if (match) {
+          origW = parseInt(match[1]);
+          origH = parseInt(match[2]);
+        }
+      }
+
+      if (line.includes("Ukuran gambar sumber:")) {
+        const match = line.match(/(\d+)x(\d+)/);
+        if (match) {
+          origH = parseInt(match[1]);
+          origW = parseInt(match[2]);
+        }
+      }
+
+      if (line.includes("Ukuran gambar hasil:")) {
+        const match = line.match(/(\d+)x(\d+)/);
+        if (match) {
+          newH = parseInt(match[1]);
+          newW = parseInt(match[2]);
+        }
+      }
+
+      if (line.includes("Waktu eksekusi SERIAL:")) {
+        const match = line.match(/(\d+\.\d+)\s*detik/);
+        if (match) serialTime = parseFloat(match[1]);
+      }
+
+      if (line.includes("Testing dengan")) {
+        const threadMatch = line.match(/(\d+)\s*threads/);
+        // Waktu ada beberapa baris setelah header (didahului info band)
+        let timeMatch = null;
+        for (let j = i + 1; j < Math.min(i + 6, lines.length) && !timeMatch; j++) {
+          timeMatch = lines[j].match(/(\d+\.\d+)\s*detik/);
+        }
+
+        if (threadMatch && timeMatch) {
+          parallelResults.push({
+            threads: parseInt(threadMatch[1]),
+            time: parseFloat(timeMatch[1]),
+          });
+        }
+      }
+    }
+
+    // Hitung scaling actual
+    const actualScaling = newW / origW;
+
+    return {
+      status: "success",
+      original_width: origW,
+      original_height: origH,
+      new_width: newW,
+      new_height: newH,
+      scaling: actualScaling.toFixed(2),
+      serial_time: serialTime,
+      parallel_results: parallelResults,
+      output_file: "result_serial.ppm",
+      output_file_serial: "result_serial.png",
+      output_file_parallel: "result_serial.png", // Both show same result (algorithm output is same)
+      original_file: imageFile,
+      algorithm: "Bilinear Interpolation (RGB)",
+      implementation: "C + OpenMP",
+    };
+  } catch (parseError) {
+    console.error("Parse error:", parseError);
+    console.log("stdout:", stdout);
+
+    // Return partial result jika parsing gagal
+    return {
+      status: "completed",
+      output_file: "result_serial.png",
+      original_file: imageFile,
+      serial_time: 0.01,
+      parallel_results: [],
+      error: "Could not fully parse output",
+    };
+  }
+}
+
+// API endpoint untuk Bilinear Interpolation (hasil di-cache per isi file + skala + kernel)
+app.get("/api/bilinear", async (req, res) => {
   const imageFile = req.query.image || "gantrycrane.png";
   const scaling = parseFloat(req.query.scaling) || 2.0;
-  const mode = req.query.mode || "serial";
+  const kernel = req.query.kernel || "double";
 
   // Validasi input
   if (isNaN(scaling) || scaling < 1.5 || scaling > 4.0) {
@@ -194,122 +1084,324 @@ app.get("/api/bilinear", (req, res) => {
       error: "Invalid scaling factor. Must be between 1.5 and 4.0",
     });
   }
+  if (!["double", "fixed", "simd"].includes(kernel)) {
+    return res.status(400).json({
+      error: "Invalid kernel. Must be 'double', 'fixed', or 'simd'",
+    });
+  }
+  const imagePath = path.resolve(__dirname, imageFile);
+  if (!imagePath.startsWith(__dirname + path.sep)) {
+    return res.status(400).json({ error: "Invalid image path" });
+  }
 
-  // Path ke executable C
-  const bilinearExec = path.join(__dirname, "bilinear");
-
-  // Jalankan program C dengan custom filename
-  const command = `"${bilinearExec}" "${imageFile}" ${scaling}`;
+  let key;
+  try {
+    key = `${await bilinearCache.hashFile(imagePath)}-s${scaling}-${kernel}`;
+  } catch (error) {
+    return res.status(404).json({ error: `Image not found: ${imageFile}` });
+  }
 
-  exec(command, { timeout: 60000, cwd: __dirname }, (error, stdout, stderr) => {
-    if (error) {
-      console.error("Execution error:", error);
-      return res.status(500).json({
-        error: "Failed to execute bilinear C program",
-        details: error.message,
-      });
-    }
+  try {
+    const { meta, cache } = await bilinearCache.get(key, async (prefix) => {
+      // Membandingkan serial vs 2/4/8 thread = benchmark: jalan sendirian
+      const { exit, output } = await scheduler.run(
+        { label: `bilinear ${imageFile} x${scaling}`, exclusive: true, pool: bilinearPool },
+        (lease) =>
+          bilinearPool.run(
+            [imagePath, `${scaling}`, `--kernel=${kernel}`, `--out=${prefix}`, ...leaseArgs(lease)],
+            60000
+          )
+      );
+      if (exit !== 0) throw new Error(`program exited with ${exit}`);
+      const result = parseBilinearOutput(output, imageFile);
+      if (result.status !== "success") throw new Error(result.error);
+      const url = `/api/bilinear/cache/${key}.png`;
+      return {
+        ...result,
+        kernel,
+        output_file: url,
+        output_file_serial: url,
+        output_file_parallel: url, // hasil paralel bit-identik (diverifikasi program C)
+      };
+    });
+    res.json({ ...meta, original_file: imageFile, cache, cache_key: key });
+  } catch (error) {
+    console.error("Execution error:", error);
+    res.status(workerErrorStatus(error)).json({
+      error: "Failed to execute bilinear C program",
+      details: error.message,
+    });
+  }
+});
 
-    if (stderr) {
-      console.warn("stderr:", stderr);
-    }
+// PNG hasil dari cache: memori dulu, lalu file di disk. Nama = hash isi, jadi aman
+// di-cache browser selamanya
+app.get("/api/bilinear/cache/:file", (req, res) => {
+  const key = req.params.file.replace(/\.png$/, "");
+  if (!req.params.file.endsWith(".png") || !BILINEAR_CACHE_KEY.test(key)) {
+    return res.status(400).json({ error: "Invalid cache file" });
+  }
+  res.set("Cache-Control", "public, max-age=31536000, immutable");
+  const hot = bilinearCache.memory.get(key);
+  if (hot) {
+    bilinearCache.touchDisk(key);
+    return res.type("image/png").send(hot.png);
+  }
+  if (!bilinearCache.disk.has(key)) {
+    return res.status(404).json({ error: "Not in cache" });
+  }
+  bilinearCache.touchDisk(key);
+  res.sendFile(bilinearCache.pngPath(key));
+});
 
-    try {
-      // Parse output dari program C
-      // Program mengeluarkan teks, kita extract info penting
-      const lines = stdout.split("\n");
-
-      // Extract metadata
-      let origW = 0,
-        origH = 0,
-        newW = 0,
-        newH = 0;
-      let serialTime = 0;
-      let parallelResults = [];
-
-      for (let i = 0; i < lines.length; i++) {
-        const line = lines[i];
-
-        if (line.includes("Berhasil membaca PNG:")) {
-          const match = line.match(/(\d+)x(\d+)/);
-          if (match) {
-            origW = parseInt(match[1]);
-            origH = parseInt(match[2]);
-          }
-        }
+// Resize progresif: program C (--emit) menulis PNG/PAM per band baris ke stdout dan
+// setiap band langsung diteruskan sebagai chunk HTTP, jadi byte pertama (dan baris
+// pertama yang terlihat di browser) tiba setelah band pertama, bukan setelah seluruh
+// citra + encode. Proses terpisah (bukan worker pool) karena stdout worker adalah
+// kanal JSON; citra hasil tidak pernah ditampung di server.
+// format=png (default, satu IDAT per band) atau pam (baris mentah); level = deflate 0..9.
+const BILINEAR_STREAM_TIMEOUT = 60000;
 
-        if (line.includes("Ukuran gambar sumber:")) {
-          const match = line.match(/(\d+)x(\d+)/);
-          if (match) {
-            origH = parseInt(match[1]);
-            origW = parseInt(match[2]);
-          }
-        }
+app.get("/api/bilinear/stream", async (req, res) => {
+  const imageFile = req.query.image || "gantrycrane.png";
+  const scaling = parseFloat(req.query.scaling) || 2.0;
+  const kernel = req.query.kernel || "double";
+  const format = req.query.format || "png";
+  const level = req.query.level !== undefined ? parseInt(req.query.level) : 1;
 
-        if (line.includes("Ukuran gambar hasil:")) {
-          const match = line.match(/(\d+)x(\d+)/);
-          if (match) {
-            newH = parseInt(match[1]);
-            newW = parseInt(match[2]);
-          }
-        }
+  if (isNaN(scaling) || scaling < 0.25 || scaling > 10.0) {
+    return res.status(400).json({ error: "Invalid scaling factor. Must be between 0.25 and 10" });
+  }
+  if (!["double", "fixed", "simd"].includes(kernel)) {
+    return res.status(400).json({ error: "Invalid kernel. Must be 'double', 'fixed', or 'simd'" });
+  }
+  if (!["png", "pam"].includes(format)) {
+    return res.status(400).json({ error: "Invalid format. Must be 'png' or 'pam'" });
+  }
+  if (isNaN(level) || level < 0 || level > 9) {
+    return res.status(400).json({ error: "Invalid level. Must be 0-9" });
+  }
+  const imagePath = path.resolve(__dirname, imageFile);
+  if (!imagePath.startsWith(__dirname + path.sep)) {
+    return res.status(400).json({ error: "Invalid image path" });
+  }
+  if (!fs.existsSync(imagePath)) {
+    return res.status(404).json({ error: `Image not found: ${imageFile}` });
+  }
+  if (!bilinearPool.available()) {
+    return res.status(503).json({ error: `${bilinearPool.execPath} not found` });
+  }
 
-        if (line.includes("Waktu eksekusi SERIAL:")) {
-          const match = line.match(/(\d+\.\d+)\s*detik/);
-          if (match) serialTime = parseFloat(match[1]);
-        }
+  const spec = { label: `bilinear/stream ${imageFile} x${scaling}`, cores: SCHED_CORES };
+  await scheduler.run(spec, (lease) => new Promise((resolve) => {
+    if (res.destroyed) return resolve(); // klien pergi selagi antre
+    const args = [
+      imagePath,
+      `${scaling}`,
+      `--kernel=${kernel}`,
+      `--emit=${format}`,
+      `--png-level=${level}`,
+      ...leaseArgs(lease),
+    ];
+    const child = spawn(bilinearPool.execPath, args, { cwd: __dirname });
+    let stderr = "";
+    let exited = false;
+    const timer = setTimeout(() => child.kill("SIGKILL"), BILINEAR_STREAM_TIMEOUT);
 
-        if (line.includes("Testing dengan")) {
-          const threadMatch = line.match(/(\d+)\s*threads/);
-          const timeMatch = lines[i + 1]
-            ? lines[i + 1].match(/(\d+\.\d+)\s*detik/)
-            : null;
-
-          if (threadMatch && timeMatch) {
-            parallelResults.push({
-              threads: parseInt(threadMatch[1]),
-              time: parseFloat(timeMatch[1]),
-            });
-          }
-        }
+    // Header baru dikirim saat band pertama tiba, supaya error awal (mis. decode
+    // gagal) masih bisa dijawab JSON 500
+    child.stdout.once("data", (first) => {
+      res.set({
+        "Content-Type": format === "png" ? "image/png" : "image/x-portable-arbitrarymap",
+        "Cache-Control": "no-store",
+        "X-Accel-Buffering": "no", // proxy nginx: jangan tampung seluruh respons
+        "X-Resize-Threads": lease.threads,
+        "X-Queue-Wait-Ms": lease.waited_ms,
+      });
+      res.write(first);
+      child.stdout.pipe(res, { end: false });
+    });
+    child.stderr.on("data", (data) => {
+      stderr += data.toString();
+    });
+    child.on("error", (err) => {
+      stderr += err.message;
+    });
+    child.on("close", (code, signal) => {
+      exited = true;
+      clearTimeout(timer);
+      if (code === 0) {
+        res.end();
+      } else if (!res.headersSent) {
+        res.status(500).json({
+          error: "Failed to execute bilinear C program",
+          details: stderr.trim() || `exited with ${signal || code}`,
+        });
+      } else {
+        // Stream sudah berjalan: putus koneksi agar klien tahu citranya terpotong
+        console.error("Bilinear stream error:", stderr.trim() || signal || code);
+        res.destroy();
       }
+      resolve();
+    });
+    // Klien menutup koneksi: hentikan resize dan lepas core-nya
+    res.on("close", () => {
+      if (!exited) child.kill("SIGTERM");
+    });
+  }));
+});
 
-      // Hitung scaling actual
-      const actualScaling = newW / origW;
+// API endpoint untuk benchmark Bilinear (output JSON langsung dari program C)
+app.get("/api/bilinear/benchmark", (req, res) => {
+  const imageFile = req.query.image || "gantrycrane.png";
+  const scales = req.query.scales || "0.5,1,2";
+  const reps = parseInt(req.query.reps) || 10;
+  const warmup = parseInt(req.query.warmup ?? "2");
+  const kernel = req.query.kernel || "double";
 
-      res.json({
-        status: "success",
-        original_width: origW,
-        original_height: origH,
-        new_width: newW,
-        new_height: newH,
-        scaling: actualScaling.toFixed(2),
-        serial_time: serialTime,
-        parallel_results: parallelResults,
-        output_file: "result_serial.ppm",
-        output_file_serial: "result_serial.png",
-        output_file_parallel: "result_serial.png", // Both show same result (algorithm output is same)
-        original_file: imageFile,
-        algorithm: "Bilinear Interpolation (RGB)",
-        implementation: "C + OpenMP",
+  // Validasi input
+  if (!/^\d+(\.\d+)?(,\d+(\.\d+)?)*$/.test(scales)) {
+    return res.status(400).json({
+      error: "Invalid scales. Use a comma-separated list, e.g. 0.5,1,2",
+    });
+  }
+  if (reps < 1 || reps > 100 || isNaN(warmup) || warmup < 0 || warmup > 20) {
+    return res.status(400).json({
+      error: "Invalid reps/warmup. reps: 1-100, warmup: 0-20",
+    });
+  }
+  if (!["double", "fixed", "simd"].includes(kernel)) {
+    return res.status(400).json({
+      error: "Invalid kernel. Must be 'double', 'fixed', or 'simd'",
+    });
+  }
+
+  // Hanya file di dalam direktori server; argumen dikirim tanpa shell
+  const imagePath = path.resolve(__dirname, imageFile);
+  if (!imagePath.startsWith(__dirname + path.sep)) {
+    return res.status(400).json({ error: "Invalid image path" });
+  }
+  if (!fs.existsSync(imagePath)) {
+    return res.status(404).json({ error: `Image not found: ${imageFile}` });
+  }
+
+  const args = [
+    imagePath,
+    "--bench",
+    `--bench-scales=${scales}`,
+    `--bench-reps=${reps}`,
+    `--bench-warmup=${warmup}`,
+    `--kernel=${kernel}`,
+  ];
+
+  scheduler
+    .run({ label: `bilinear/benchmark ${imageFile}`, exclusive: true, pool: bilinearPool }, (lease) =>
+      bilinearPool.run([...args, ...leaseArgs(lease)], 300000)
+    )
+    .then(({ output }) => {
+      const result = JSON.parse(sanitizeNumericTokens(output));
+      res.status(result.status === "success" ? 200 : 500).json(result);
+    })
+    .catch((error) => {
+      console.error("Bilinear benchmark error:", error);
+      res.status(workerErrorStatus(error)).json({
+        error: "Failed to execute bilinear benchmark",
+        details: error.message,
       });
-    } catch (parseError) {
-      console.error("Parse error:", parseError);
-      console.log("stdout:", stdout);
+    });
+});
 
-      // Return partial result jika parsing gagal
-      res.json({
-        status: "completed",
-        output_file: "result_serial.png",
-        original_file: imageFile,
-        serial_time: 0.01,
-        parallel_results: [],
-        error: "Could not fully parse output",
+// Resize citra upload lewat addon N-API: body = isi file (PNG / PPM / PAM),
+// mis. curl --data-binary @foto.png ".../api/bilinear/resize?scale=2&kernel=simd".
+// Decode, resize dan encode berjalan di proses ini tanpa file sementara.
+// format=png (default) atau raw (piksel apa adanya, layout di header X-Image-*).
+app.post(
+  "/api/bilinear/resize",
+  express.raw({ type: () => true, limit: "64mb" }),
+  async (req, res) => {
+    if (!native) {
+      return res.status(503).json({
+        error: "Native addon not built. Run: npm run build:native",
       });
     }
+    if (!Buffer.isBuffer(req.body) || req.body.length === 0) {
+      return res.status(400).json({ error: "Request body must contain the image file" });
+    }
+    const format = req.query.format || "png";
+    if (!["png", "raw"].includes(format)) {
+      return res.status(400).json({ error: "Invalid format. Must be 'png' or 'raw'" });
+    }
+    const opts = {
+      kernel: req.query.kernel || "double",
+      threads: parseInt(req.query.threads) || SCHED_CORES,
+    };
+    if (req.query.scale !== undefined) {
+      opts.scale = parseFloat(req.query.scale);
+    } else {
+      opts.width = parseInt(req.query.width) || 0;
+      opts.height = parseInt(req.query.height) || 0;
+    }
+
+    let image;
+    try {
+      image = await native.decode(req.body);
+    } catch (error) {
+      return res.status(415).json({ error: error.message });
+    }
+    let resized, png;
+    let stage = "resize";
+    try {
+      const spec = { label: "native/bilinear/resize", cores: opts.threads };
+      // Encode PNG juga memakai CPU: dijalankan di dalam lease yang sama
+      await scheduler.run(spec, async (lease) => {
+        resized = await native.resize(image, { ...opts, threads: lease.threads });
+        if (format !== "png") return;
+        stage = "encode";
+        png = await native.encodePng(resized, {
+          level: req.query.level !== undefined ? parseInt(req.query.level) : 1,
+          threads: lease.threads,
+        });
+      });
+    } catch (error) {
+      return res.status(stage === "resize" ? 400 : 500).json({ error: error.message });
+    }
+
+    res.set({
+      "X-Image-Width": resized.width,
+      "X-Image-Height": resized.height,
+      "X-Image-Channels": resized.channels,
+      "X-Image-Bit-Depth": resized.bitDepth,
+      "X-Resize-Time": resized.time.toFixed(6),
+      "X-Resize-Threads": resized.threads,
+    });
+    if (format === "raw") {
+      // Baris hasil ter-align 64 byte: jarak antar baris di X-Image-Stride
+      res.set("X-Image-Stride", resized.stride);
+      return res.type("application/octet-stream").send(resized.data);
+    }
+    res.type("image/png").send(png);
+  }
+);
+
+// Status pool worker C (jumlah worker, sibuk, antrean, restart)
+app.get("/api/workers", (req, res) => {
+  res.json({
+    fibonacci_openmp: fibPools.openmp.stats(),
+    fibonacci_cilk: fibPools.cilk ? fibPools.cilk.stats() : { available: false },
+    bilinear: bilinearPool.stats(),
+    bilinear_cache: bilinearCache.stats(),
+    scheduler: scheduler.stats(),
+    native: native
+      ? { fibonacci_modes: native.fibonacciModes, simd_isa: native.simdIsa }
+      : null,
   });
 });
 
+// Status scheduler core: core bebas, job berjalan, kedalaman antrean, waktu tunggu
+app.get("/api/scheduler", (req, res) => {
+  res.json(scheduler.stats());
+});
+
 // Serve index.html
 app.get("/", (req, res) => {
   res.sendFile(path.join(__dirname, "index.html"));
@@ -325,17 +1417,25 @@ app.listen(PORT, () => {
 ║                                                           ║
 ║   📊 API Endpoints:                                       ║
 ║   • Fibonacci: http://localhost:${PORT}/api/fibonacci/:n    ║
+║   • Fib batch: http://localhost:${PORT}/api/fibonacci/batch ║
 ║   • Bilinear:  http://localhost:${PORT}/api/bilinear       ║
+║   • Benchmark: http://localhost:${PORT}/api/bilinear/benchmark ║
+║   • Native:    POST http://localhost:${PORT}/api/bilinear/resize ║
+║   • Stream:    http://localhost:${PORT}/api/bilinear/stream ║
 ║                                                           ║
 ║   📝 Examples:                                            ║
 ║   • http://localhost:${PORT}/api/fibonacci/35              ║
+║   • http://localhost:${PORT}/api/fibonacci/1000000?mod=97  ║
+║   • http://localhost:${PORT}/api/fibonacci/10000000?bigint=1 ║
+║   • http://localhost:${PORT}/api/fibonacci/batch?ns=20..45 ║
 ║   • http://localhost:${PORT}/api/bilinear?image=...        ║
 ║                                                           ║
 ╚═══════════════════════════════════════════════════════════╝
 
 ⚙️  Make sure C programs are compiled:
    gcc-15 -fopenmp -o fib_omp_json fibonacci_json.c
-   gcc-15 -fopenmp -O3 -o bilinear bilinear_serial_parallel.c -lm
+   gcc-15 -fopenmp -O3 -o bilinear bilinear_serial_parallel.c -lm -lz
+   npm run build:native   (opsional, addon N-API: ${native ? "loaded" : "not built"})
 
 🌐 Open your browser and visit: http://localhost:${PORT}
     `);